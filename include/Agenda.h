@@ -0,0 +1,50 @@
+/**
+ * @file Agenda.h
+ * @brief Intervalo entre varreduras adaptado à chuva, limitado pelo orçamento de airtime
+ * @details O ciclo base é o NVM_LoRaWAN_Cycle_Time (EEPROM). A chuva é somada em
+ *          janelas móveis na memória RTC: intensidade na última hora
+ *          (compartimentos de 5 min) e acumulado em 24 h (compartimentos de 1 h).
+ *          Acima dos limiares RAIN_* o ciclo encurta (chuva / chuva forte); sem
+ *          báscula por RAIN_DRY_HOURS ele alonga (estiagem). O airtime dos
+ *          uplinks da última hora não passa de AIRTIME_DUTY_PERMIL: se o próximo
+ *          envio estourar o orçamento, a espera é estendida até liberar espaço.
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _AGENDA_H
+#define _AGENDA_H
+
+#include <stdint.h>
+
+typedef enum {
+  AGENDA_ESTIAGEM = 0,                    // sem chuva por RAIN_DRY_HOURS
+  AGENDA_BASE,                            // ciclo da EEPROM
+  AGENDA_CHUVA,                           // RAIN_RATE_MM_H ou RAIN_ACC_MM
+  AGENDA_CHUVA_FORTE,                     // RAIN_HEAVY_RATE_MM_H ou RAIN_HEAVY_ACC_MM
+} t_eAgendaNivel;
+
+/**
+ * @brief Marca o início do ciclo (varredura dos sensores)
+ */
+void agendaInicioCiclo(void);
+
+/**
+ * @brief Soma às janelas de chuva as básculas contadas desde a última chamada
+ * @note Não chama atualizaChuva() (pode ser chamada no despertar pelo pluviômetro)
+ */
+void agendaChuva(void);
+
+/**
+ * @brief Registra o airtime de um uplink aceito pelo módulo
+ * @param airtime Tempo no ar [ms] (LoRaHandler::getAirtime)
+ */
+void agendaUplink(uint32_t airtime);
+
+/**
+ * @brief Espera até a próxima varredura
+ * @param cicloMin Ciclo base [min] (NVM_LoRaWAN_Cycle_Time)
+ * @return uint32_t Restante do ciclo desde agendaInicioCiclo [ms], no mínimo NEXT_MSG_TIMEOUT_VALUE
+ */
+uint32_t agendaEspera(uint8_t cicloMin);
+
+#endif /* _AGENDA_H */
@@ -0,0 +1,51 @@
+/**
+ * @file Amostra.h
+ * @brief Amostra numérica dos sensores, independente do formato do frame
+ * @details Sem dependências de hardware: também é usado pelo decodificador
+ *          do servidor (ver PayloadSchema.h).
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _AMOSTRA_H
+#define _AMOSTRA_H
+
+#include <stdint.h>
+
+#define NUM_SPENDIO   3                   // Sensores SPendio nos frames v01-v04: S (base), M (meio), T (topo)
+#define SPENDIO_MAX   16                  // Nós SPendio por string (registro e frame v05)
+#define SPENDIO_ENDERECOS "SMTABCDEFGHIJKLN"  // Endereço RS485 de cada posição (S, M, T primeiro)
+#define TEMP_FALHA    (-1000)             // Temperatura em falha de leitura (-100,0 °C)
+
+struct SPendio_Amostra_Type {
+  bool valido;                            // respondeu à varredura
+  uint16_t acx;                           // acc X
+  uint16_t acy;                           // acc Y
+  uint16_t acz;                           // acc Z
+  uint32_t solo;                          // solo
+};
+
+// Dispersão dos eixos na janela de amostragem (S, M, T)
+struct SPendio_Estat_Type {
+  uint16_t desvio[3];                     // desvio padrão X, Y, Z [1/4 de contagem]
+  uint16_t pp[3];                         // pico a pico X, Y, Z [contagens]
+};
+
+struct CPendio_Amostra_Type {
+  SPendio_Amostra_Type spendio[SPENDIO_MAX];   // por posição em SPENDIO_ENDERECOS (acc: média da janela)
+  SPendio_Estat_Type estat[NUM_SPENDIO];  // dispersão na janela
+  uint8_t janela;                         // leituras na janela (0: leitura única)
+  int16_t temp;                           // temperatura [0,1 °C]
+  uint8_t umid;                           // umidade [%]
+  uint32_t pressao;                       // pressão [Pa] (0 = falha)
+  uint16_t pluv;                          // contagem do pluviômetro
+  uint16_t bat;                           // tensão da bateria no ADC [mV]
+};
+
+// Alarme de inclinação (frame na porta TILT_ALARM_PORT)
+struct Alarme_Inclinacao_Type {
+  uint16_t mapa;                          // bit i = posição i de SPENDIO_ENDERECOS em alarme
+  uint16_t angulo[SPENDIO_MAX];           // deslocamento em relação à base [mrad]
+  uint16_t taxa[SPENDIO_MAX];             // velocidade do deslocamento [mrad/s]
+};
+
+#endif /* _AMOSTRA_H */
@@ -12,7 +12,7 @@
 #define CR 0x0D
 #define LF 0x0A
 
-#define SPENDIO_TIMEOUT   20        // 200 ms
+#define SPENDIO_TIMEOUT   200       // ms - prazo de cada transação RS485
 
 typedef unsigned char uchar;
 typedef unsigned int  uint;
@@ -44,5 +44,8 @@ typedef unsigned short ushort;
 #include "WRCPendio.h"
 #include "HW.h"
 #include "Sensores.h"
+#include "Chuva.h"
+#include "Bateria.h"
+#include "Inclinacao.h"
 
 #endif /* _APL_H */
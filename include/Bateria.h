@@ -0,0 +1,25 @@
+#ifndef _BATERIA_H
+#define _BATERIA_H
+
+//------------------------------------------------------------------------------
+//  Monitor da bateria (aVBat, ADC1)
+//
+//  BATTERY_USE_DMA = 1 : ADC em modo contínuo (DMA) amostrando em segundo
+//                        plano; a task BAT filtra cada bloco (mediana das
+//                        médias) e converte com a calibração do eFuse. A
+//                        leitura só copia o último valor (não bloqueia).
+//                        Se o ADC contínuo não inicia, cai na leitura
+//                        direta abaixo (sem a queda no TX).
+//  BATTERY_USE_DMA = 0 : média de 8 leituras analogReadMilliVolts (~8 ms).
+//
+//  Queda no TX: bateriaInicioTX() guarda o nível antes do rádio (média do
+//  anel de valores recentes) e bateriaFimTX() devolve o nível mínimo
+//  visto durante o envio (ENERGY_TX_TIME_MS), subtraído desse nível.
+//
+void iniBateria(void);
+bool bateriaMilliVolts(uint16_t &mv);
+void bateriaInicioTX(void);
+uint16_t bateriaFimTX(void);
+uint16_t bateriaQuedaTX(void);
+
+#endif /* _BATERIA_H */
@@ -0,0 +1,31 @@
+#ifndef _CHUVA_H
+#define _CHUVA_H
+
+//------------------------------------------------------------------------------
+//  Pluviômetro (báscula): contador de pulsos em nChuva
+//
+//  RAIN_USE_ULP = 1 : o ULP lê o pino (RTC GPIO) a cada 2 ms, faz o debounce
+//                     (DEBDmax) e conta na RTC_SLOW_MEM, acordado ou em deep
+//                     sleep; atualizaChuva soma o que o ULP contou. Em deep
+//                     sleep só acorda o ESP32 a cada RAIN_ULP_WAKE_TIPS
+//                     básculas ou no modo diagnóstico (TEMPO_DIAG).
+//                     Padrão com ENABLE_DEEP_SLEEP.
+//  RAIN_USE_ISR = 1 : interrupção nas bordas; a báscula vale quando o pino
+//                     fica DEBDmax sem bordas (temporizador do FreeRTOS).
+//                     Sem task periódica, mas cada borda acorda a CPU.
+//  RAIN_USE_ISR = 0 : task de varredura a cada 1 ms (debounce por software).
+//
+//  O PCNT não serve: o filtro (até 12,8 us) não rejeita o repique do reed,
+//  de milissegundos. Sem o ULP, em deep sleep o pino acorda o ESP32 (EXT0)
+//  a cada báscula; ela é contada no boot (contaChuvaAcordar) e o sistema
+//  volta a dormir pelo restante do ciclo.
+//
+extern int16_t contChuva;                   // contador de básculas (memória RTC)
+
+void iniChuva(void);
+void atualizaChuva(void);
+void preparaSonoChuva(void);
+bool contaChuvaAcordar(void);
+void vTaskVarreSensorChuva(void *pvParameters);
+
+#endif /* _CHUVA_H */
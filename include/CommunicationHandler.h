@@ -77,6 +77,8 @@ public:
 
     /**
      * @brief Tenta se conectar ao servidor/rede
+     * @details Implementações podem ser assíncronas: nesse caso a conexão avança
+     *          em process() e o estado fica CONNECTING até a conclusão.
      * @return bool true se conectado, false caso contrário
      */
     virtual bool connect() = 0;
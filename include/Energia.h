@@ -0,0 +1,58 @@
+/**
+ * @file Energia.h
+ * @brief Modelo de consumo: fases de um ciclo de uplink e corrente média
+ * @details As fases seguem a máquina de estados do main.cpp com os mesmos
+ *          parâmetros: STATE_READY acordado (ENERGY_ACTIVE_TIME_MS) e o rádio
+ *          (ENERGY_TX_TIME_MS, TX + RX1/RX2). Em STATE_WAIT_CFM o ESP32 fica
+ *          acordado consultando o ACK (AT+CFS=?, CFM_POLL_INTERVAL) por até
+ *          CFM_POLL_WINDOW; sem ACK, o resto do CFM_TIMEOUT_VALUE é uma espera
+ *          ociosa (com ENABLE_DEEP_SLEEP, em deep sleep e mais um boot). O
+ *          resto do ciclo também é ocioso. Sem deep sleep o ESP32 nunca dorme.
+ *          O modelo é o do uplink confirmado (padrão sem EEPROM); sem
+ *          confirmação, STATE_WAIT_CFM segue a regra de NACK do ciclo curto
+ *          (NEXT_MSG_TIMEOUT_VALUE), que não é modelada.
+ *
+ *          Ajuste os parâmetros ENERGY_* com medições da placa. A tabela por
+ *          tempo de ciclo sai do teste no host:
+ *
+ *              pio test -e native -f test_energia -v
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _ENERGIA_H
+#define _ENERGIA_H
+
+#include <stdint.h>
+
+/**
+ * @brief Tempo de um ciclo por fase [ms]
+ */
+struct Energia_Ciclo_Type {
+  uint32_t ativoMs;                         // acordado sem rádio (boots, varredura, espera do ACK)
+  uint32_t txMs;                            // rádio (TX + janelas RX)
+  uint32_t sonoMs;                          // deep sleep
+};
+
+/**
+ * @brief Fases de um ciclo como o firmware o percorre
+ * @param cicloMs Tempo de ciclo [ms]
+ * @param ack O ACK chega na primeira transmissão (false: só o timeout encerra a espera)
+ * @param deepSleep Deep sleep nas esperas ociosas (ENABLE_DEEP_SLEEP)
+ * @return Energia_Ciclo_Type Fases (somam cicloMs, ou mais se as fases não cabem no ciclo)
+ */
+Energia_Ciclo_Type energiaCiclo(uint32_t cicloMs, bool ack, bool deepSleep);
+
+/**
+ * @brief Corrente média de um ciclo com as correntes ENERGY_*
+ * @return uint32_t [uA]
+ */
+uint32_t energiaCorrenteMedia(const Energia_Ciclo_Type &ciclo);
+
+/**
+ * @brief Autonomia com a bateria ENERGY_BATTERY_MAH
+ * @param correnteUa Corrente média [uA]
+ * @return uint32_t [dias] (0 se a corrente é 0)
+ */
+uint32_t energiaAutonomiaDias(uint32_t correnteUa);
+
+#endif /* _ENERGIA_H */
@@ -0,0 +1,85 @@
+/**
+ * @file Falhas.h
+ * @brief Gerenciador de falhas: contadores por classe, recuperação do LoRa e reinício agendado
+ * @details Cada falha soma no contador da classe e no de falhas seguidas
+ *          (zerado no sucesso). A cada FAULT_RECOVER_AFTER seguidas roda a
+ *          recuperação registrada (reset do módulo LoRa e novo JOIN); em
+ *          MAX_SEQUENTIAL_ERRORS o ESP32 reinicia (esp_restart). Recuperação e
+ *          reinício são agendados nos temporizadores do loop (Temporizador.h):
+ *          o passo atual termina e nada fica bloqueado esperando.
+ *
+ *          A causa do reinício e os totais por classe ficam na memória RTC
+ *          não inicializada: sobrevivem ao esp_restart, ao watchdog e ao
+ *          deep sleep, e são zerados no power-on.
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _FALHAS_H
+#define _FALHAS_H
+
+#include <stdint.h>
+#include "Temporizador.h"
+
+typedef enum {
+  FALHA_LORA_TX = 0,                        // envio recusado pelo módulo
+  FALHA_LORA_CFM,                           // uplink confirmado sem ACK / NACK esgotados
+  FALHA_LORA_MODULO,                        // módulo não reinicializou na recuperação
+  FALHA_ESTADO,                             // estado inválido da máquina de estados
+  FALHA_QUANT
+} t_eFalha;
+
+typedef enum {
+  REINICIO_ENERGIA = 0,                     // power-on (ou causa desconhecida)
+  REINICIO_FALHAS,                          // MAX_SEQUENTIAL_ERRORS falhas seguidas
+  REINICIO_PEDIDO,                          // downlink 0x82
+  REINICIO_WATCHDOG,                        // watchdog da task ou de interrupção
+  REINICIO_PANICO,                          // exceção / abort
+  REINICIO_TENSAO,                          // brownout
+  REINICIO_EXTERNO,                         // pino EN ou esp_restart não agendado
+  REINICIO_QUANT
+} t_eReinicio;
+
+/**
+ * @brief Identifica a causa do boot e cria os temporizadores (no início do setup)
+ */
+void iniFalhas(void);
+
+/**
+ * @brief Define a recuperação rodada a cada FAULT_RECOVER_AFTER falhas seguidas
+ * @param cb Callback (contexto do loop)
+ */
+void falhasRecuperacao(Temporizador_Cb cb);
+
+/**
+ * @brief Registra uma falha (pode agendar a recuperação ou o reinício)
+ */
+void falhaRegistra(t_eFalha falha);
+
+/**
+ * @brief Operação bem-sucedida: zera as falhas seguidas
+ */
+void falhasLimpa(void);
+
+/**
+ * @brief Agenda um esp_restart limpo
+ * @param causa Gravada para o próximo boot
+ * @param atraso [ms] (FAULT_RESTART_DELAY: termina o passo atual e esvazia o log)
+ */
+void falhasReinicia(t_eReinicio causa, uint32_t atraso);
+
+/**
+ * @brief Causa do último reinício
+ */
+t_eReinicio falhasCausaReinicio(void);
+
+/**
+ * @brief Reinícios desde o power-on
+ */
+uint16_t falhasReinicios(void);
+
+/**
+ * @brief Total de uma classe de falha desde o power-on
+ */
+uint16_t falhasTotal(t_eFalha falha);
+
+#endif /* _FALHAS_H */
@@ -0,0 +1,49 @@
+/**
+ * @file Historico.h
+ * @brief Fila circular de amostras com horário, mantida na memória RTC
+ * @details Guarda as amostras ainda não enviadas para que várias sejam
+ *          transmitidas no mesmo uplink (lote v03, ver Payload.h).
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _HISTORICO_H
+#define _HISTORICO_H
+
+#include <stdint.h>
+#include "Amostra.h"
+
+struct Registro_Amostra_Type {
+  uint32_t tempo;                         // PowerManager::rtcSegundos() [s]
+  CPendio_Amostra_Type amostra;
+};
+
+/**
+ * @brief Acrescenta uma amostra (descarta a mais antiga se a fila estiver cheia)
+ * @param amostra Leitura dos sensores
+ * @param tempo Horário da leitura [s]
+ */
+void historicoAdiciona(const CPendio_Amostra_Type &amostra, uint32_t tempo);
+
+/**
+ * @brief Quantidade de amostras guardadas
+ */
+uint8_t historicoQuant(void);
+
+/**
+ * @brief Capacidade da fila
+ */
+uint8_t historicoCapacidade(void);
+
+/**
+ * @brief Lê uma amostra
+ * @param i Índice (0 = mais antiga)
+ */
+const Registro_Amostra_Type &historicoLe(uint8_t i);
+
+/**
+ * @brief Descarta as amostras mais antigas (já enviadas)
+ * @param n Quantidade
+ */
+void historicoDescarta(uint8_t n);
+
+#endif /* _HISTORICO_H */
@@ -0,0 +1,28 @@
+#ifndef _INCLINACAO_H
+#define _INCLINACAO_H
+
+//------------------------------------------------------------------------------
+//  Amostragem contínua dos SPendio (inclinação)
+//
+//  A task TILT varre os nós registrados a cada TILT_SAMPLE_PERIOD_MS e
+//  acumula, por nó e por eixo, média e variância (Welford em ponto fixo),
+//  mínimo e máximo. Com a amostragem ligada ela é a única a usar o RS485;
+//  a varredura dos sensores pega o resumo da janela (média no lugar da
+//  leitura instantânea, desvio e pico a pico em estat) e abre outra janela.
+//
+//  Detector (TILT_ALARM_ENABLED): a cada varredura compara o vetor de cada
+//  nó com a base (média das primeiras leituras, mantida no deep sleep) e
+//  dispara o alarme pelo ângulo, pela taxa de variação e com histerese. O
+//  laço principal envia o alarme na porta TILT_ALARM_PORT sem esperar o
+//  ciclo.
+//
+//  Só amostra com o ESP32 acordado: em deep sleep a janela cobre o tempo
+//  acordado de cada ciclo.
+//
+void iniInclinacao(void);
+void inclinacaoJanela(CPendio_Amostra_Type &amostra);
+bool inclinacaoAlarme(Alarme_Inclinacao_Type &alarme);
+void inclinacaoAlarmeEnviado(uint16_t mapa);
+void inclinacaoNovaBase(void);
+
+#endif /* _INCLINACAO_H */
@@ -26,8 +26,22 @@ struct LoRaConfig {
     unsigned long joinTimeout;              // Timeout para join (ms)
     unsigned long confirmTimeout;           // Timeout para confirmação (ms)
     uint8_t maxRetries;                     // Máximo de tentativas de envio
+    unsigned long linkPollInterval;         // Intervalo entre consultas ativas do link (ms)
+    unsigned long cfmPollInterval;          // Intervalo entre consultas da confirmação após a RX2 (ms)
 };
 
+/**
+ * @brief Callback de conclusão do JOIN
+ * @param connected true se conectado, false em caso de falha/timeout
+ */
+typedef void (*ConnectCallback)(bool connected);
+
+/**
+ * @brief Callback de conclusão da espera da confirmação (ACK)
+ * @param confirmed true se confirmado, false no timeout
+ */
+typedef void (*ConfirmCallback)(bool confirmed);
+
 /**
  * @class LoRaHandler
  * @brief Handler de comunicação para LoRaWAN
@@ -40,7 +54,17 @@ private:
     bool confirmed;                         // Flag de confirmação
     DownlinkMessage lastDownlink;           // Última mensagem recebida
     unsigned long lastSendTime;             // Tempo do último envio
+    unsigned long rxEndTime;                // Fim da janela RX2 do último envio
+    unsigned long lastCfmPoll;              // Última consulta da confirmação (AT+CFS)
     uint8_t retryCount;                     // Contador de tentativas
+    bool linkJoined;                        // Estado do link em cache (JOIN)
+    bool linkKnown;                         // Cache já foi preenchido
+    unsigned long lastLinkPoll;             // Tempo da última consulta/evento do link
+    unsigned long joinStartTime;            // Início do JOIN em andamento
+    uint8_t dataRate;                       // Data rate em cache (AT+DR)
+    bool dataRateKnown;                     // Cache do data rate é válido
+    ConnectCallback connectCallback;        // Notificação de conclusão do JOIN
+    ConfirmCallback confirmCallback;        // Notificação da confirmação do envio
 
 public:
     /**
@@ -60,19 +84,54 @@ public:
      */
     bool begin() override;
 
+    /**
+     * @brief Retoma o handler após o deep sleep do ESP32
+     * @details O módulo LoRa continua alimentado e mantém a sessão; apenas
+     *          verifica a comunicação (sem ATZ) e atualiza o estado do link.
+     * @return bool true se o módulo respondeu
+     */
+    bool resume();
+
     /**
      * @brief Finaliza o handler LoRa
      */
     void end() override;
 
     /**
-     * @brief Conecta à rede LoRaWAN (OTAA Join)
-     * @return bool true se conectado
+     * @brief Inicia a conexão à rede LoRaWAN (OTAA Join) sem bloquear
+     * @details O JOIN avança em process(); o resultado é informado pelo estado
+     *          (CONNECTING -> CONNECTED/ERROR) e pelo callback de conclusão.
+     * @return bool true se já conectado, false se o JOIN foi iniciado ou falhou
      */
     bool connect() override;
 
+    /**
+     * @brief Define o callback chamado ao concluir o JOIN
+     * @param callback Função chamada com o resultado (nullptr desativa)
+     */
+    void setConnectCallback(ConnectCallback callback);
+
+    /**
+     * @brief Define o callback chamado ao concluir a espera da confirmação
+     * @details Depois da janela RX2, process() consulta AT+CFS=? a cada
+     *          cfmPollInterval: o ACK é informado segundos após o envio, sem
+     *          esperar o confirmTimeout.
+     * @param callback Função chamada com o resultado (nullptr desativa)
+     */
+    void setConfirmCallback(ConfirmCallback callback);
+
+    /**
+     * @brief Janelas de recepção (RX1/RX2) do último envio já terminaram
+     * @details Estimativa: tempo no ar + RECEIVE_DELAY2 + a janela RX2.
+     * @return bool true se o módulo está livre para outro comando de rádio
+     */
+    bool rxWindowsDone();
+
     /**
      * @brief Verifica se está conectado
+     * @details Usa o estado em cache, atualizado pelos envios e pela consulta
+     *          ao módulo (AT+NJS) quando o cache expira ou chega a notificação
+     *          de JOIN.
      * @return bool true se conectado
      */
     bool isConnected() override;
@@ -106,7 +165,8 @@ public:
     ConnectionState getConnectionState() override;
 
     /**
-     * @brief Processa eventos LoRa
+     * @brief Processa eventos LoRa (avança o JOIN e verifica timeouts)
+     * @note Deve ser chamado a cada passagem do loop()
      */
     void process() override;
 
@@ -144,12 +204,62 @@ public:
      */
     bool setDataRate(uint8_t dr);
 
+    /**
+     * @brief Payload máximo no data rate atual (AU915, sem dwell time)
+     * @details Usa o data rate em cache (readDataRate), sem ida e volta na UART.
+     * @return uint8_t Tamanho máximo da aplicação [bytes]
+     */
+    uint8_t getMaxPayload();
+
+    /**
+     * @brief Tempo no ar de um uplink no data rate atual (AU915)
+     * @details Fórmula da Semtech (AN1200.13): preâmbulo de 8 símbolos, cabeçalho
+     *          explícito, CR 4/5, CRC e otimização de baixa taxa em SF11/SF12.
+     *          Soma 13 bytes do cabeçalho LoRaWAN (MHDR, FHDR, FPort e MIC).
+     *          Usa o data rate guardado no último send(), sem comando AT.
+     * @param length Payload da aplicação [bytes] (binário, não o ASCII hexa)
+     * @return uint32_t Tempo no ar [ms]
+     */
+    uint32_t getAirtime(uint8_t length);
+
+    /**
+     * @brief Registra no log a latência das respostas de cada comando AT
+     * @details Útil para avaliar o custo do boot (begin) e do ciclo de uplink
+     */
+    void logLatencyStats();
+
 private:
+    /**
+     * @brief Data rate atual, em cache
+     * @details Só consulta o módulo (AT+DR) quando o cache é inválido: no boot e,
+     *          com ADR, depois de cada uplink (as janelas RX podem trazer um
+     *          LinkADRReq). Em falha mantém o último valor conhecido (DR0 se nenhum).
+     */
+    uint8_t readDataRate();
+
     /**
      * @brief Atualiza o estado da conexão
      */
     void updateState();
 
+    /**
+     * @brief Processa as notificações assíncronas do módulo (JOIN: antecipa a consulta)
+     */
+    void handleEvents();
+
+    /**
+     * @brief Obtém o estado do link, consultando o módulo se o cache expirou
+     * @param maxAge Idade máxima do cache (ms)
+     * @return bool true se conectado
+     */
+    bool linkStatus(unsigned long maxAge);
+
+    /**
+     * @brief Conclui o JOIN em andamento e notifica o callback
+     * @param connected Resultado do JOIN
+     */
+    void finishConnect(bool connected);
+
     /**
      * @brief Traduz CommandResponse para SendResult
      */
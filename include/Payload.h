@@ -0,0 +1,125 @@
+/**
+ * @file Payload.h
+ * @brief Formatação do frame de uplink a partir da amostra dos sensores
+ * @details O primeiro byte do frame é sempre a versão do formato, para que o
+ *          servidor decodifique v01 e v02. Os campos estão definidos uma única
+ *          vez em PayloadSchema.h (ver docs/PROTOCOLO.md).
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _PAYLOAD_H
+#define _PAYLOAD_H
+
+#include <stdint.h>
+#include "Sensores.h"
+#include "PayloadSchema.h"
+
+#define PAYLOAD_V01           0x01        // ASCII hexa (CPendio_Sensor_Data_Type)
+#define PAYLOAD_V02           0x02        // binário compactado por largura de campo
+#define PAYLOAD_V03           0x03        // lote de amostras v02 com idade
+#define PAYLOAD_V04           0x04        // lote keyframe/delta
+#define PAYLOAD_V05           0x05        // número variável de nós SPendio
+#define PAYLOAD_V06           0x06        // v02 + dispersão da janela de inclinação
+#define PAYLOAD_ALARME        0x07        // alarme de inclinação (porta TILT_ALARM_PORT)
+
+#define PAYLOAD_V02_SIZE      (PayloadSchema::EsquemaV02::bytes)
+#define PAYLOAD_V06_SIZE      (PayloadSchema::EsquemaV06::bytes)
+
+/**
+ * @brief Monta o frame v01 (ASCII hexa, terminado em zero)
+ * @param amostra Leitura dos sensores
+ * @param dado Estrutura do frame v01
+ */
+void montaPayloadV01(const CPendio_Amostra_Type &amostra, CPendio_Sensor_Data_Type &dado);
+
+/**
+ * @brief Monta o frame v02 (binário, campos na largura real)
+ * @param amostra Leitura dos sensores
+ * @param frame Destino (mínimo PAYLOAD_V02_SIZE bytes)
+ * @return uint8_t Tamanho do frame [bytes]
+ */
+uint8_t montaPayloadV02(const CPendio_Amostra_Type &amostra, uint8_t *frame);
+
+/**
+ * @brief Quantas amostras cabem em um frame
+ * @param maxBytes Payload máximo no data rate atual [bytes]
+ * @return uint8_t Amostras por frame (mínimo 1)
+ */
+uint8_t amostrasPorFrame(uint16_t maxBytes);
+
+/**
+ * @brief Monta o frame com as n amostras mais antigas do histórico
+ * @details Uma amostra é enviada como v02 (compatível); mais de uma como lote v03.
+ * @param n Quantidade de amostras (1 a LOTE_MAX)
+ * @param agora Horário do envio [s], para a idade das amostras
+ * @param frame Destino (mínimo PayloadSchema::bytesLote(n) bytes)
+ * @return uint8_t Tamanho do frame [bytes]
+ */
+uint8_t montaPayloadLote(uint8_t n, uint32_t agora, uint8_t *frame);
+
+/**
+ * @brief Monta o frame v04 (keyframe/delta) com as amostras mais antigas do histórico
+ * @details Cada amostra é codificada como diferença da anterior; a primeira do
+ *          frame usa a última amostra do frame aceito anterior. Vira keyframe
+ *          se não houver referência, se a presença dos sensores mudar, se alguma
+ *          diferença não couber ou a cada DELTA_KEYFRAME_INTERVAL frames.
+ *          O frame só é montado quando a próxima amostra não caberia mais, a
+ *          fila estiver cheia ou a amostra mais antiga tiver DELTA_MAX_AGE.
+ * @param maxBytes Payload máximo no data rate atual [bytes]
+ * @param agora Horário do envio [s], para a idade das amostras
+ * @param frame Destino (mínimo maxBytes bytes)
+ * @param n Amostras colocadas no frame
+ * @return uint8_t Tamanho do frame [bytes] (0 = aguardar mais amostras)
+ */
+uint8_t montaPayloadDelta(uint16_t maxBytes, uint32_t agora, uint8_t *frame, uint8_t &n);
+
+/**
+ * @brief Frame v04 aceito pelo módulo: descarta as amostras e adota a referência
+ * @param n Amostras do frame (retorno de montaPayloadDelta)
+ */
+void payloadDeltaAceito(uint8_t n);
+
+/**
+ * @brief Frame possivelmente perdido (sem ACK, falha ou pedido do servidor):
+ *        o próximo frame v04 começa com keyframe
+ */
+void payloadDeltaPerdido(void);
+
+/**
+ * @brief Monta o frame v05 com os nós SPendio registrados
+ * @details Se todos os nós não couberem no payload do data rate atual, o frame
+ *          leva os que couberem e o próximo começa do primeiro que ficou de fora
+ *          (rodízio).
+ * @param amostra Leitura dos sensores
+ * @param registro Posições de SPENDIO_ENDERECOS registradas (bit i = posição i)
+ * @param maxBytes Payload máximo no data rate atual [bytes]
+ * @param frame Destino (mínimo maxBytes bytes)
+ * @return uint8_t Tamanho do frame [bytes]
+ */
+uint8_t montaPayloadV05(const CPendio_Amostra_Type &amostra, uint16_t registro, uint16_t maxBytes, uint8_t *frame);
+
+/**
+ * @brief Monta o frame v06 (v02 + desvio e pico a pico dos eixos na janela)
+ * @param amostra Leitura dos sensores (resumo da janela de amostragem)
+ * @param frame Destino (mínimo PAYLOAD_V06_SIZE bytes)
+ * @return uint8_t Tamanho do frame [bytes]
+ */
+uint8_t montaPayloadV06(const CPendio_Amostra_Type &amostra, uint8_t *frame);
+
+/**
+ * @brief Monta o frame de alarme de inclinação
+ * @param alarme Nós em alarme com o ângulo e a taxa
+ * @param frame Destino (mínimo PayloadSchema::bytesAlarme(SPENDIO_MAX) bytes)
+ * @return uint8_t Tamanho do frame [bytes]
+ */
+uint8_t montaPayloadAlarme(const Alarme_Inclinacao_Type &alarme, uint8_t *frame);
+
+/**
+ * @brief Converte um frame binário em ASCII hexa para o AT+SENDX
+ * @param frame Frame binário
+ * @param tam Tamanho do frame [bytes]
+ * @param hex Destino (mínimo 2 * tam + 1 caracteres, terminado em zero)
+ */
+void payloadHex(const uint8_t *frame, uint8_t tam, char *hex);
+
+#endif /* _PAYLOAD_H */
@@ -0,0 +1,626 @@
+/**
+ * @file PayloadSchema.h
+ * @brief Esquema dos frames de uplink em tempo de compilação
+ * @details Cada formato é uma lista de campos (largura em bits, sinal e acesso
+ *          à amostra). O codificador do firmware, o decodificador do servidor e
+ *          os tamanhos (static_assert) são gerados pelos templates a partir da
+ *          mesma lista, sem tabelas consultadas em tempo de execução.
+ *
+ *          Não depende do Arduino: o servidor pode compilar o decodificador com
+ *          `g++ -std=c++11 -Iinclude` (ver docs/PROTOCOLO.md).
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _PAYLOAD_SCHEMA_H
+#define _PAYLOAD_SCHEMA_H
+
+#include <stdint.h>
+#include "Amostra.h"
+
+namespace PayloadSchema {
+
+// ----------------------------------------------------------------------------
+// Acesso aos bits (MSB primeiro)
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Grava um campo no frame (o frame deve estar zerado)
+ */
+inline void putBits(uint8_t *frame, uint16_t pos, uint32_t valor, uint8_t bits) {
+  while (bits) {
+    bits--;
+    if ((valor >> bits) & 1) frame[pos >> 3] |= (uint8_t)(0x80 >> (pos & 7));
+    pos++;
+  }
+}
+
+/**
+ * @brief Lê um campo do frame
+ */
+inline uint32_t getBits(const uint8_t *frame, uint16_t pos, uint8_t bits) {
+  uint32_t valor = 0;
+  while (bits) {
+    bits--;
+    valor = (valor << 1) | ((frame[pos >> 3] >> (7 - (pos & 7))) & 1);
+    pos++;
+  }
+  return valor;
+}
+
+// ----------------------------------------------------------------------------
+// Campos
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Campo de BITS bits
+ * @tparam SINAL Complemento de 2 (valores fora da faixa são saturados)
+ * @tparam ACESSO Tipo com `static int32_t le(const Amostra&)` e
+ *                `static void grava(Amostra&, int32_t)`
+ */
+template <uint8_t BITS, bool SINAL, typename ACESSO>
+struct Campo {
+  static_assert(BITS > 0 && BITS <= 31, "largura de campo inválida");
+
+  static constexpr uint16_t bits = BITS;
+  static constexpr int32_t maximo = (int32_t)((1UL << (BITS - (SINAL ? 1 : 0))) - 1);
+  static constexpr int32_t minimo = SINAL ? -maximo : 0;
+
+  static void codifica(const CPendio_Amostra_Type &a, uint8_t *frame, uint16_t pos) {
+    int32_t v = ACESSO::le(a);
+    if (v > maximo) v = maximo;
+    if (v < minimo) v = minimo;
+    putBits(frame, pos, (uint32_t)v, BITS);
+  }
+
+  static void decodifica(const uint8_t *frame, uint16_t pos, CPendio_Amostra_Type &a) {
+    uint32_t v = getBits(frame, pos, BITS);
+    if (SINAL && (v >> (BITS - 1))) v |= ~(uint32_t)0 << BITS;        // estende o sinal
+    ACESSO::grava(a, (int32_t)v);
+  }
+};
+
+/**
+ * @brief Lista ordenada de campos (ou de outros esquemas)
+ */
+template <typename... CAMPOS>
+struct Esquema;
+
+template <>
+struct Esquema<> {
+  static constexpr uint16_t bits = 0;
+  static void codifica(const CPendio_Amostra_Type &, uint8_t *, uint16_t) {}
+  static void decodifica(const uint8_t *, uint16_t, CPendio_Amostra_Type &) {}
+};
+
+template <typename C, typename... R>
+struct Esquema<C, R...> {
+  static constexpr uint16_t bits = C::bits + Esquema<R...>::bits;
+  static constexpr uint8_t bytes = (uint8_t)((bits + 7) / 8);
+
+  static void codifica(const CPendio_Amostra_Type &a, uint8_t *frame, uint16_t pos = 0) {
+    C::codifica(a, frame, pos);
+    Esquema<R...>::codifica(a, frame, pos + C::bits);
+  }
+
+  static void decodifica(const uint8_t *frame, uint16_t pos, CPendio_Amostra_Type &a) {
+    C::decodifica(frame, pos, a);
+    Esquema<R...>::decodifica(frame, pos + C::bits, a);
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Acessos à amostra
+// ----------------------------------------------------------------------------
+
+template <uint8_t VALOR>
+struct Constante {
+  static int32_t le(const CPendio_Amostra_Type &) { return VALOR; }
+  static void grava(CPendio_Amostra_Type &, int32_t) {}
+};
+
+template <uint8_t I>
+struct Presenca {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? 1 : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.spendio[I].valido = (v != 0); }
+};
+
+// Sensor SPendio ausente: campos zerados
+template <uint8_t I> struct Acx {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? a.spendio[I].acx : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.spendio[I].acx = (uint16_t)v; }
+};
+template <uint8_t I> struct Acy {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? a.spendio[I].acy : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.spendio[I].acy = (uint16_t)v; }
+};
+template <uint8_t I> struct Acz {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? a.spendio[I].acz : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.spendio[I].acz = (uint16_t)v; }
+};
+template <uint8_t I> struct Solo {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? (int32_t)a.spendio[I].solo : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.spendio[I].solo = (uint32_t)v; }
+};
+
+struct TempDeci {                         // 0,1 °C
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.temp; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.temp = (int16_t)v; }
+};
+struct TempGraus {                        // °C inteiro (v01)
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.temp / 10; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.temp = (int16_t)(v * 10); }
+};
+struct Umid {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.umid; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.umid = (uint8_t)v; }
+};
+struct Pressao {
+  static int32_t le(const CPendio_Amostra_Type &a) { return (int32_t)a.pressao; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.pressao = (uint32_t)v; }
+};
+struct Pluv {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.pluv; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.pluv = (uint16_t)v; }
+};
+struct Bat {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.bat; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.bat = (uint16_t)v; }
+};
+
+// Dispersão na janela (v06): sensor ausente, campos zerados
+template <uint8_t I, uint8_t E> struct Desvio {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? a.estat[I].desvio[E] : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.estat[I].desvio[E] = (uint16_t)v; }
+};
+template <uint8_t I, uint8_t E> struct PicoAPico {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.spendio[I].valido ? a.estat[I].pp[E] : 0; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.estat[I].pp[E] = (uint16_t)v; }
+};
+struct Janela {
+  static int32_t le(const CPendio_Amostra_Type &a) { return a.janela; }
+  static void grava(CPendio_Amostra_Type &a, int32_t v) { a.janela = (uint8_t)v; }
+};
+
+// ----------------------------------------------------------------------------
+// Formatos
+// ----------------------------------------------------------------------------
+
+/** @brief v01: campos com largura múltipla de 4 bits, enviados como ASCII hexa */
+template <uint8_t I>
+using SPendioV01 = Esquema<Campo<12, false, Acx<I>>, Campo<12, false, Acy<I>>,
+                           Campo<12, false, Acz<I>>, Campo<20, false, Solo<I>>>;
+
+typedef Esquema<Campo<8, false, Constante<0x01>>,
+                SPendioV01<0>, SPendioV01<1>, SPendioV01<2>,
+                Campo<8, true, TempGraus>,
+                Campo<8, false, Umid>,
+                Campo<20, false, Pressao>,
+                Campo<16, false, Pluv>,
+                Campo<12, false, Bat>> EsquemaV01;
+
+/** @brief v02: campos na largura real */
+template <uint8_t I>
+using SPendioV02 = Esquema<Campo<10, false, Acx<I>>, Campo<10, false, Acy<I>>,
+                           Campo<10, false, Acz<I>>, Campo<20, false, Solo<I>>>;
+
+/** @brief Sensores ambientais e de alimentação (v02 e v05) */
+typedef Esquema<Campo<11, true, TempDeci>,
+                Campo<7, false, Umid>,
+                Campo<17, false, Pressao>,
+                Campo<16, false, Pluv>,
+                Campo<12, false, Bat>> AmbienteV02;
+
+/** @brief Corpo de uma amostra v02 (sem o byte de versão), também usado no lote v03 */
+typedef Esquema<Campo<1, false, Presenca<0>>, Campo<1, false, Presenca<1>>, Campo<1, false, Presenca<2>>,
+                SPendioV02<0>, SPendioV02<1>, SPendioV02<2>,
+                AmbienteV02> AmostraV02;
+
+typedef Esquema<Campo<8, false, Constante<0x02>>, AmostraV02> EsquemaV02;
+
+/**
+ * @brief v03: lote de amostras v02 com a idade de cada uma
+ * @details versao(8) + quantidade(4) + N x (idade(16) + AmostraV02)
+ */
+const uint8_t  LOTE_BITS_VERSAO = 8;
+const uint8_t  LOTE_BITS_QUANT  = 4;
+const uint8_t  LOTE_BITS_IDADE  = 16;     // segundos antes do envio (saturado)
+const uint8_t  LOTE_MAX         = (1 << LOTE_BITS_QUANT) - 1;
+
+/**
+ * @brief Tamanho de um lote v03 com n amostras [bytes]
+ */
+constexpr uint16_t bytesLote(uint8_t n) {
+  return (LOTE_BITS_VERSAO + LOTE_BITS_QUANT + (uint32_t)n * (LOTE_BITS_IDADE + AmostraV02::bits) + 7) / 8;
+}
+
+/**
+ * @brief v05: amostra com número variável de nós SPendio
+ * @details versao(8) + mapa(16, bit i = posição i de SPENDIO_ENDERECOS no frame)
+ *          + AmbienteV02 + um NoV05 por bit do mapa, em ordem crescente
+ */
+template <uint8_t I>
+using NoV05 = Esquema<Campo<1, false, Presenca<I>>, SPendioV02<I>>;
+
+const uint8_t V05_BITS_MAPA = 16;
+
+/**
+ * @brief Seleciona em tempo de execução o NoV05 da posição indicada
+ */
+template <uint8_t I = 0>
+struct NosV05 {
+  static void codifica(uint8_t no, const CPendio_Amostra_Type &a, uint8_t *frame, uint16_t pos) {
+    if (no == I) NoV05<I>::codifica(a, frame, pos);
+    else NosV05<I + 1>::codifica(no, a, frame, pos);
+  }
+  static void decodifica(uint8_t no, const uint8_t *frame, uint16_t pos, CPendio_Amostra_Type &a) {
+    if (no == I) NoV05<I>::decodifica(frame, pos, a);
+    else NosV05<I + 1>::decodifica(no, frame, pos, a);
+  }
+};
+
+template <>
+struct NosV05<SPENDIO_MAX> {
+  static void codifica(uint8_t, const CPendio_Amostra_Type &, uint8_t *, uint16_t) {}
+  static void decodifica(uint8_t, const uint8_t *, uint16_t, CPendio_Amostra_Type &) {}
+};
+
+/**
+ * @brief Tamanho de um frame v05 com n nós [bytes]
+ */
+constexpr uint16_t bytesV05(uint8_t n) {
+  return (LOTE_BITS_VERSAO + V05_BITS_MAPA + AmbienteV02::bits + (uint32_t)n * NoV05<0>::bits + 7) / 8;
+}
+
+/**
+ * @brief v06: amostra v02 (acc = média da janela) + dispersão de cada eixo
+ * @details versao(8) + AmostraV02 + janela(8) + 3 x EstatV06
+ */
+template <uint8_t I>
+using EstatV06 = Esquema<Campo<8, false, Desvio<I, 0>>, Campo<8, false, Desvio<I, 1>>, Campo<8, false, Desvio<I, 2>>,
+                         Campo<10, false, PicoAPico<I, 0>>, Campo<10, false, PicoAPico<I, 1>>,
+                         Campo<10, false, PicoAPico<I, 2>>>;
+
+typedef Esquema<Campo<8, false, Constante<0x06>>, AmostraV02,
+                Campo<8, false, Janela>,
+                EstatV06<0>, EstatV06<1>, EstatV06<2>> EsquemaV06;
+
+/**
+ * @brief Alarme de inclinação (porta própria)
+ * @details versao(8) + mapa(16) + um (angulo + taxa) por bit do mapa, em ordem crescente
+ */
+const uint8_t ALARME_BITS_ANGULO = 12;    // mrad (saturado)
+const uint8_t ALARME_BITS_TAXA   = 12;    // mrad/s (saturado)
+
+/**
+ * @brief Tamanho de um frame de alarme com n nós [bytes]
+ */
+constexpr uint16_t bytesAlarme(uint8_t n) {
+  return (LOTE_BITS_VERSAO + V05_BITS_MAPA + (uint32_t)n * (ALARME_BITS_ANGULO + ALARME_BITS_TAXA) + 7) / 8;
+}
+
+static_assert(NUM_SPENDIO == 3, "os esquemas v01-v04 e v06 listam 3 sensores SPendio");
+static_assert(SPENDIO_MAX <= V05_BITS_MAPA, "mapa v05 menor que SPENDIO_MAX");
+static_assert(EsquemaV01::bits % 4 == 0, "v01 é enviado em dígitos hexa");
+static_assert(EsquemaV02::bytes == 28, "v02 mudou de tamanho: atualize docs/PROTOCOLO.md");
+static_assert(EsquemaV06::bytes == 50, "v06 mudou de tamanho: atualize docs/PROTOCOLO.md");
+
+// ----------------------------------------------------------------------------
+// Delta (v04)
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Diferença com sinal de BITS bits de um campo em relação à referência
+ * @details Cada campo tem um bit no mapa de alterações; só os alterados levam
+ *          a diferença.
+ */
+template <uint8_t BITS, typename ACESSO>
+struct Delta {
+  static_assert(BITS > 1 && BITS <= 31, "largura de delta inválida");
+
+  static constexpr uint8_t campos = 1;
+  static constexpr int32_t maximo = (int32_t)((1UL << (BITS - 1)) - 1);
+
+  static int32_t diferenca(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r) {
+    return ACESSO::le(a) - ACESSO::le(r);
+  }
+
+  static bool cabe(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r) {
+    int32_t d = diferenca(a, r);
+    return (d >= -maximo) && (d <= maximo);
+  }
+
+  static uint16_t bits(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r) {
+    return diferenca(a, r) ? BITS : 0;
+  }
+
+  static void codifica(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r,
+                       uint8_t *frame, uint16_t mapa, uint16_t &dados) {
+    int32_t d = diferenca(a, r);
+    if (d) {
+      putBits(frame, mapa, 1, 1);
+      putBits(frame, dados, (uint32_t)d, BITS);
+      dados += BITS;
+    }
+  }
+
+  static void decodifica(const uint8_t *frame, uint16_t mapa, uint16_t &dados, CPendio_Amostra_Type &a) {
+    if (getBits(frame, mapa, 1)) {
+      uint32_t v = getBits(frame, dados, BITS);
+      if (v >> (BITS - 1)) v |= ~(uint32_t)0 << BITS;            // estende o sinal
+      ACESSO::grava(a, ACESSO::le(a) + (int32_t)v);
+      dados += BITS;
+    }
+  }
+};
+
+/**
+ * @brief Lista ordenada de deltas (ou de outras listas)
+ */
+template <typename... DELTAS>
+struct ListaDelta;
+
+template <>
+struct ListaDelta<> {
+  static constexpr uint8_t campos = 0;
+  static bool cabe(const CPendio_Amostra_Type &, const CPendio_Amostra_Type &) { return true; }
+  static uint16_t bits(const CPendio_Amostra_Type &, const CPendio_Amostra_Type &) { return 0; }
+  static void codifica(const CPendio_Amostra_Type &, const CPendio_Amostra_Type &,
+                       uint8_t *, uint16_t, uint16_t &) {}
+  static void decodifica(const uint8_t *, uint16_t, uint16_t &, CPendio_Amostra_Type &) {}
+};
+
+template <typename D, typename... R>
+struct ListaDelta<D, R...> {
+  static constexpr uint8_t campos = D::campos + ListaDelta<R...>::campos;
+
+  static bool cabe(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r) {
+    return D::cabe(a, r) && ListaDelta<R...>::cabe(a, r);
+  }
+
+  static uint16_t bits(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r) {
+    return D::bits(a, r) + ListaDelta<R...>::bits(a, r);
+  }
+
+  static void codifica(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r,
+                       uint8_t *frame, uint16_t mapa, uint16_t &dados) {
+    D::codifica(a, r, frame, mapa, dados);
+    ListaDelta<R...>::codifica(a, r, frame, mapa + D::campos, dados);
+  }
+
+  static void decodifica(const uint8_t *frame, uint16_t mapa, uint16_t &dados, CPendio_Amostra_Type &a) {
+    D::decodifica(frame, mapa, dados, a);
+    ListaDelta<R...>::decodifica(frame, mapa + D::campos, dados, a);
+  }
+};
+
+template <uint8_t I>
+using SPendioDelta = ListaDelta<Delta<6, Acx<I>>, Delta<6, Acy<I>>, Delta<6, Acz<I>>, Delta<12, Solo<I>>>;
+
+/** @brief Campos de uma amostra delta (a presença dos sensores não muda: senão é keyframe) */
+typedef ListaDelta<SPendioDelta<0>, SPendioDelta<1>, SPendioDelta<2>,
+                   Delta<7, TempDeci>,
+                   Delta<5, Umid>,
+                   Delta<10, Pressao>,
+                   Delta<8, Pluv>,
+                   Delta<7, Bat>> AmostraDelta;
+
+static_assert(AmostraDelta::campos == 17, "mapa v04 mudou: atualize docs/PROTOCOLO.md");
+
+/**
+ * @brief v04: lote de amostras keyframe/delta
+ * @details versao(8) + quantidade(4) + N x (idade(16) + tipo(1) +
+ *          [tipo 1: AmostraV02 | tipo 0: mapa(AmostraDelta::campos) + deltas])
+ */
+const uint8_t DELTA_BITS_TIPO = 1;
+
+/**
+ * @brief Mesma presença de sensores SPendio (condição para delta)
+ */
+inline bool mesmaPresenca(const CPendio_Amostra_Type &a, const CPendio_Amostra_Type &r) {
+  for (uint8_t i = 0; i < NUM_SPENDIO; i++) {
+    if (a.spendio[i].valido != r.spendio[i].valido) return false;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Decodificador (servidor)
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Decodifica um frame binário (v01 convertido de ASCII hexa, v02 ou v06)
+ * @param frame Frame recebido
+ * @param tam Tamanho [bytes]
+ * @param a Amostra decodificada
+ * @return bool false se a versão for desconhecida ou o tamanho não conferir
+ */
+inline bool decodifica(const uint8_t *frame, uint8_t tam, CPendio_Amostra_Type &a) {
+  if (tam == 0) return false;
+
+  a = CPendio_Amostra_Type();
+  switch (frame[0]) {
+    case 0x01:
+      if (tam != EsquemaV01::bytes) return false;
+      EsquemaV01::decodifica(frame, 0, a);
+      for (uint8_t i = 0; i < NUM_SPENDIO; i++) {   // v01 não tem bit de presença
+        a.spendio[i].valido = (a.spendio[i].acx | a.spendio[i].acy | a.spendio[i].acz | a.spendio[i].solo) != 0;
+      }
+      return true;
+    case 0x02:
+      if (tam != EsquemaV02::bytes) return false;
+      EsquemaV02::decodifica(frame, 0, a);
+      return true;
+    case 0x06:
+      if (tam != EsquemaV06::bytes) return false;
+      EsquemaV06::decodifica(frame, 0, a);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Decodifica um lote v03 (ou um frame v01/v02 como lote de uma amostra)
+ * @param frame Frame recebido
+ * @param tam Tamanho [bytes]
+ * @param a Amostras decodificadas, da mais antiga para a mais recente
+ * @param idade Idade de cada amostra no envio [s]
+ * @param max Capacidade de a[] e idade[]
+ * @return uint8_t Quantidade de amostras (0 se o frame for inválido)
+ */
+inline uint8_t decodificaLote(const uint8_t *frame, uint8_t tam, CPendio_Amostra_Type *a,
+                              uint16_t *idade, uint8_t max) {
+  if (tam == 0 || max == 0) return 0;
+
+  if (frame[0] != 0x03) {
+    idade[0] = 0;
+    return decodifica(frame, tam, a[0]) ? 1 : 0;
+  }
+
+  uint16_t pos = LOTE_BITS_VERSAO;
+  uint8_t n = (uint8_t)getBits(frame, pos, LOTE_BITS_QUANT);
+  pos += LOTE_BITS_QUANT;
+  if (n == 0 || n > max || tam != bytesLote(n)) return 0;
+
+  for (uint8_t i = 0; i < n; i++) {
+    idade[i] = (uint16_t)getBits(frame, pos, LOTE_BITS_IDADE);
+    pos += LOTE_BITS_IDADE;
+    a[i] = CPendio_Amostra_Type();
+    AmostraV02::decodifica(frame, pos, a[i]);
+    pos += AmostraV02::bits;
+  }
+  return n;
+}
+
+/**
+ * @brief Decodifica um frame v05 (número variável de nós SPendio)
+ * @param frame Frame recebido
+ * @param tam Tamanho [bytes]
+ * @param a Amostra decodificada (nós fora do mapa ficam zerados)
+ * @param mapa Posições de SPENDIO_ENDERECOS presentes no frame
+ * @return bool false se a versão for desconhecida ou o tamanho não conferir
+ */
+inline bool decodificaV05(const uint8_t *frame, uint8_t tam, CPendio_Amostra_Type &a, uint16_t &mapa) {
+  if (tam < bytesV05(0) || frame[0] != 0x05) return false;
+
+  uint16_t pos = LOTE_BITS_VERSAO;
+  mapa = (uint16_t)getBits(frame, pos, V05_BITS_MAPA);
+  pos += V05_BITS_MAPA;
+
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < V05_BITS_MAPA; i++) {
+    if (mapa & (1U << i)) n++;
+  }
+  if ((mapa >> SPENDIO_MAX) || (tam != bytesV05(n))) return false;
+
+  a = CPendio_Amostra_Type();
+  AmbienteV02::decodifica(frame, pos, a);
+  pos += AmbienteV02::bits;
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+    if (!(mapa & (1U << i))) continue;
+    NosV05<>::decodifica(i, frame, pos, a);
+    pos += NoV05<0>::bits;
+  }
+  return true;
+}
+
+/**
+ * @brief Decodifica um frame de alarme de inclinação (porta TILT_ALARM_PORT)
+ * @param frame Frame recebido
+ * @param tam Tamanho [bytes]
+ * @param a Alarme decodificado (nós fora do mapa ficam zerados)
+ * @return bool false se a versão for desconhecida ou o tamanho não conferir
+ */
+inline bool decodificaAlarme(const uint8_t *frame, uint8_t tam, Alarme_Inclinacao_Type &a) {
+  if (tam < bytesAlarme(0) || frame[0] != 0x07) return false;
+
+  uint16_t pos = LOTE_BITS_VERSAO;
+  a = Alarme_Inclinacao_Type();
+  a.mapa = (uint16_t)getBits(frame, pos, V05_BITS_MAPA);
+  pos += V05_BITS_MAPA;
+
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < V05_BITS_MAPA; i++) {
+    if (a.mapa & (1U << i)) n++;
+  }
+  if ((a.mapa >> SPENDIO_MAX) || (tam != bytesAlarme(n))) return false;
+
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+    if (!(a.mapa & (1U << i))) continue;
+    a.angulo[i] = (uint16_t)getBits(frame, pos, ALARME_BITS_ANGULO);
+    pos += ALARME_BITS_ANGULO;
+    a.taxa[i] = (uint16_t)getBits(frame, pos, ALARME_BITS_TAXA);
+    pos += ALARME_BITS_TAXA;
+  }
+  return true;
+}
+
+/**
+ * @brief Estado do decodificador v04 (um por dispositivo, no servidor)
+ */
+struct EstadoDelta {
+  CPendio_Amostra_Type referencia;        // última amostra reconstruída
+  bool valida;                            // referência utilizável
+  uint32_t fcnt;                          // FCnt do último frame v04
+};
+
+/**
+ * @brief Decodifica um frame v04 (keyframe/delta)
+ * @details Regra de perda: se o FCnt não for o seguinte ao do último frame,
+ *          a referência é descartada e as amostras delta ficam sem reconstrução
+ *          (ok[i] = false) até o próximo keyframe. O servidor pode pedir um
+ *          keyframe imediato pelo downlink 0x86.
+ * @param frame Frame recebido
+ * @param tam Tamanho [bytes]
+ * @param fcnt Contador de frames de uplink (FCnt) do LoRaWAN
+ * @param estado Estado do dispositivo (inicializar com valida = false)
+ * @param a Amostras, da mais antiga para a mais recente
+ * @param idade Idade de cada amostra no envio [s]
+ * @param ok Amostra reconstruída
+ * @param max Capacidade de a[], idade[] e ok[]
+ * @return uint8_t Quantidade de amostras (0 se o frame for inválido)
+ */
+inline uint8_t decodificaDelta(const uint8_t *frame, uint8_t tam, uint32_t fcnt, EstadoDelta &estado,
+                               CPendio_Amostra_Type *a, uint16_t *idade, bool *ok, uint8_t max) {
+  if (tam < 2 || frame[0] != 0x04) return 0;
+
+  if (estado.valida && (fcnt != estado.fcnt + 1)) estado.valida = false;     // frame perdido
+  estado.fcnt = fcnt;
+
+  uint16_t fim = (uint16_t)tam * 8;
+  uint16_t pos = LOTE_BITS_VERSAO;
+  uint8_t n = (uint8_t)getBits(frame, pos, LOTE_BITS_QUANT);
+  pos += LOTE_BITS_QUANT;
+  if (n == 0 || n > max) return 0;
+
+  for (uint8_t i = 0; i < n; i++) {
+    if (pos + LOTE_BITS_IDADE + DELTA_BITS_TIPO > fim) return 0;
+    idade[i] = (uint16_t)getBits(frame, pos, LOTE_BITS_IDADE);
+    pos += LOTE_BITS_IDADE;
+    bool key = getBits(frame, pos, DELTA_BITS_TIPO);
+    pos += DELTA_BITS_TIPO;
+
+    if (key) {
+      if (pos + AmostraV02::bits > fim) return 0;
+      a[i] = CPendio_Amostra_Type();
+      AmostraV02::decodifica(frame, pos, a[i]);
+      pos += AmostraV02::bits;
+      estado.valida = true;
+    }
+    else {
+      if (pos + AmostraDelta::campos > fim) return 0;
+      uint16_t dados = pos + AmostraDelta::campos;
+      a[i] = estado.referencia;
+      AmostraDelta::decodifica(frame, pos, dados, a[i]);
+      if (dados > fim) return 0;
+      pos = dados;
+    }
+    ok[i] = estado.valida;
+    if (estado.valida) estado.referencia = a[i];
+  }
+  return n;
+}
+
+} // namespace PayloadSchema
+
+#endif /* _PAYLOAD_SCHEMA_H */
@@ -0,0 +1,72 @@
+/**
+ * @file PowerManager.h
+ * @brief Gerenciamento de energia: deep sleep entre ciclos
+ * @details O estado da máquina de estados é mantido na memória RTC (RTC_DATA_ATTR)
+ *          e o firmware retoma o ciclo ao acordar do deep sleep. O modelo de
+ *          consumo (ENERGY_*) roda no host: test/test_energia.
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _POWER_MANAGER_H
+#define _POWER_MANAGER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @class PowerManager
+ * @brief Funções de energia (deep sleep e relógio RTC)
+ */
+class PowerManager {
+public:
+  /**
+   * @brief Identifica a causa do boot (deve ser chamado no início do setup)
+   */
+  static void begin();
+
+  /**
+   * @brief Indica se o boot foi uma volta do deep sleep (estado RTC válido)
+   * @return bool true se acordou do deep sleep
+   */
+  static bool isWarmBoot();
+
+  /**
+   * @brief Indica se o despertar foi causado por um pino (EXT0, ex.: pluviômetro)
+   * @return bool true se acordou por GPIO
+   */
+  static bool isGpioWake();
+
+  /**
+   * @brief Tempo restante do último deep sleep programado
+   * @note Usado para voltar a dormir após um despertar antecipado por GPIO
+   * @return uint32_t Tempo restante [ms] (0 se já expirou)
+   */
+  static uint32_t remainingSleep();
+
+  /**
+   * @brief Tempo em ms do relógio RTC, contínuo através do deep sleep
+   * @note millis() reinicia a cada boot; este relógio não
+   * @return uint32_t Tempo em ms (com passagem por zero a cada ~49 dias)
+   */
+  static uint32_t rtcMillis();
+
+  /**
+   * @brief Tempo em s do relógio RTC, contínuo através do deep sleep
+   * @note Sem a passagem por zero do rtcMillis(): use para carimbos de tempo
+   * @return uint32_t Tempo em s
+   */
+  static uint32_t rtcSegundos();
+
+  /**
+   * @brief Entra em deep sleep pelo tempo indicado (não retorna)
+   * @param ms Tempo de sono [ms]
+   */
+  static void deepSleep(uint32_t ms);
+
+private:
+  static bool _warmBoot;
+  static bool _gpioWake;
+  static uint32_t _sleepUntil;              // rtcMillis() do fim do sono (memória RTC)
+};
+
+#endif /* _POWER_MANAGER_H */
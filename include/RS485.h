@@ -0,0 +1,43 @@
+#ifndef _RS485_H
+#define _RS485_H
+
+//------------------------------------------------------------------------------
+//  Barramento RS485 dos sensores SPendio (Serial2, half-duplex)
+//
+//  Motor de transações dirigido por evento: os pedidos vão para uma fila, a
+//  task RS485 envia o endereço, passa o barramento para recepção logo após o
+//  último bit e espera a resposta (terminada em LF) notificada pelo onReceive
+//  da UART, sem varredura. Ao terminar a resposta (ou vencer o prazo) o
+//  resultado vai para a fila de conclusões e o próximo pedido é enviado em
+//  seguida. Quem espera o resultado fica bloqueado na fila (CPU livre).
+//
+//  Modo binário: o pedido é o endereço com o bit 7 ligado e a resposta é um
+//  frame LEN + LEN bytes + CRC-16/Modbus (LSB primeiro), encerrado pelo
+//  tamanho. Um sensor só ASCII não responde ao pedido binário.
+//
+#define RS485_TAM_RESPOSTA  32              // resposta máxima (com o LF ou o CRC)
+#define RS485_MAX_PEDIDOS   8               // pedidos na fila
+#define RS485_PEDIDO_BIN    0x80            // bit do pedido binário
+
+typedef enum {
+  RS485_OK = 0,                             // resposta completa (terminada em LF)
+  RS485_TIMEOUT,                            // prazo vencido
+  RS485_ESTOURO,                            // resposta maior que RS485_TAM_RESPOSTA
+  RS485_ERRO_CRC,                           // frame binário com CRC inválido
+} t_eRS485Status;
+
+struct RS485_Transacao_Type {
+  char endereco;                            // endereço do sensor
+  uint8_t status;                           // t_eRS485Status
+  bool binario;                             // pedido/resposta no modo binário
+  uint8_t tam;                              // bytes na resposta (sem o LF; com LEN e CRC)
+  char resposta[RS485_TAM_RESPOSTA];        // ASCII: terminada em zero
+  uint32_t duracao;                         // do envio ao fim da resposta [ms]
+};
+
+void iniRS485(void);
+bool rs485Pede(char endereco, uint16_t prazo, bool binario = false);
+bool rs485Resultado(RS485_Transacao_Type &t, uint32_t espera);
+uint16_t crc16Modbus(const uint8_t *dados, uint8_t tam);
+
+#endif /* _RS485_H */
@@ -0,0 +1,48 @@
+/**
+ * @file Reconexao.h
+ * @brief Espera entre tentativas de JOIN (OTAA): recuo exponencial com jitter
+ * @details Depois de cada JOIN sem sucesso a espera dobra, de JOIN_BACKOFF_MIN
+ *          até JOIN_BACKOFF_MAX, e é sorteada entre a metade e o valor cheio.
+ *          O sorteio usa um gerador semeado pelo DevEUI: cada dispositivo tem
+ *          sua sequência, e um local inteiro que perdeu o gateway não volta a
+ *          tentar em sincronia. O número de tentativas e o gerador ficam na
+ *          memória RTC não inicializada: sobrevivem ao deep sleep e ao
+ *          esp_restart (o reinício não zera o recuo) e são zerados no power-on.
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _RECONEXAO_H
+#define _RECONEXAO_H
+
+#include <stdint.h>
+
+/**
+ * @brief Valida o registro e semeia o gerador (no setup, após ler o DevEUI)
+ * @param deveui DevEUI do módulo (nullptr se a leitura falhou)
+ * @param n Tamanho do DevEUI [bytes]
+ */
+void iniReconexao(const char *deveui, uint8_t n);
+
+/**
+ * @brief JOIN sem sucesso: conta a tentativa
+ * @return uint32_t Espera até a próxima tentativa [ms]
+ */
+uint32_t reconexaoFalhou(void);
+
+/**
+ * @brief Espera antes do primeiro JOIN do boot
+ * @return uint32_t 0 sem tentativas pendentes; senão a espera da última contada [ms]
+ */
+uint32_t reconexaoEspera(void);
+
+/**
+ * @brief JOIN concluído: zera as tentativas
+ */
+void reconexaoOk(void);
+
+/**
+ * @brief JOINs sem sucesso seguidos
+ */
+uint16_t reconexaoTentativas(void);
+
+#endif /* _RECONEXAO_H */
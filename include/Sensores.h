@@ -12,6 +12,8 @@
 #ifndef _SENSORES_H
 #define _SENSORES_H
 
+#include "Amostra.h"
+
 struct SPendio_Data_Type {        // 3+3+3+5= 14 bytes
   char acx[3];                            // acc X
   char acy[3];                            // acc Y
@@ -71,8 +73,11 @@ global Adafruit_BMP280 bmp;
 global bool g_bBMPPresente;
 global bool g_bDiag;
 
-void vTaskVarreSensorChuva(void *pvParameters);
-void iniSensores(CPendio_Sensor_Data_Type &dado);
-void varrSensores(CPendio_Sensor_Data_Type &data);
+void iniSensores(void);
+void iniI2C(void);
+void varrSensores(CPendio_Amostra_Type &amostra);
+void varrSensoresSPendio(CPendio_Amostra_Type &amostra);
+void descobreSPendio(void);
+uint16_t registroSPendio(void);
 
 #endif /* _SENSORES_H */
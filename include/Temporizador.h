@@ -0,0 +1,69 @@
+/**
+ * @file Temporizador.h
+ * @brief Temporizadores do loop() em roda hierárquica (timer wheel)
+ * @details Base de tempo: millis() (1 tick = 1 ms). Quatro níveis de 256
+ *          compartimentos cobrem os 32 bits do tempo; o temporizador entra no
+ *          nível da distância até o prazo e desce de nível (cascata) quando o
+ *          nível de baixo dá a volta. Armar e vencer são O(1); o
+ *          processamento pula os compartimentos vazios pelo mapa de ocupação.
+ *          As comparações são pela diferença com sinal, seguras na passagem
+ *          do millis() por zero (~49,7 dias): prazos até 2^31 ms à frente.
+ *
+ *          Os callbacks rodam em temporizadorProcessa() (contexto do loop).
+ *          O estado fica na RAM: após o deep sleep os temporizadores são
+ *          criados e armados de novo no setup(). Por isso só os criados com
+ *          acorda = true (ex.: o ciclo) limitam o deep sleep; os de manutenção
+ *          (watchdog, estatísticas) só valem com o ESP32 acordado.
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef _TEMPORIZADOR_H
+#define _TEMPORIZADOR_H
+
+#include <stdint.h>
+
+#define TEMPORIZADOR_MAX   8                // temporizadores disponíveis
+
+typedef void (*Temporizador_Cb)(void *arg);
+
+/**
+ * @brief Cria um temporizador (desarmado)
+ * @param cb Função chamada no vencimento
+ * @param acorda Conta para temporizadorProximo (o deep sleep termina no vencimento)
+ * @param arg Argumento do callback
+ * @return int8_t Identificador, ou -1 se não houver temporizador livre
+ */
+int8_t temporizadorCria(Temporizador_Cb cb, bool acorda = true, void *arg = nullptr);
+
+/**
+ * @brief Arma (ou rearma) um temporizador
+ * @param id Identificador (temporizadorCria)
+ * @param prazo Vencimento [ms] na base do millis() (já vencido: roda no próximo processamento)
+ * @param periodo Repetição [ms] a partir do prazo (0 = uma vez)
+ */
+void temporizadorArma(int8_t id, uint32_t prazo, uint32_t periodo = 0);
+
+/**
+ * @brief Desarma um temporizador
+ */
+void temporizadorDesarma(int8_t id);
+
+/**
+ * @brief Tempo até o vencimento [ms] (0 se vencido ou desarmado)
+ */
+uint32_t temporizadorRestante(int8_t id);
+
+/**
+ * @brief Executa os callbacks dos temporizadores vencidos até millis()
+ */
+void temporizadorProcessa(void);
+
+/**
+ * @brief Tempo até o próximo vencimento (para o deep sleep)
+ * @details Só os temporizadores criados com acorda = true.
+ * @param espera [ms] (0 se já há temporizador vencido)
+ * @return bool false se nenhum deles está armado
+ */
+bool temporizadorProximo(uint32_t &espera);
+
+#endif /* _TEMPORIZADOR_H */
@@ -48,9 +48,21 @@
 /** @brief Timeout para OTAA Join [ms] */
 #define JOIN_TIMEOUT_VALUE          10000
 
+/** @brief Recuo após o 1º JOIN sem sucesso [ms]; dobra a cada tentativa, sorteado entre a metade e o valor cheio */
+#define JOIN_BACKOFF_MIN            15000
+
+/** @brief Recuo máximo entre tentativas de JOIN [ms] */
+#define JOIN_BACKOFF_MAX            3600000   // 1 hora
+
 /** @brief Timeout para aguardar ACK/CFM [ms] */
 #define CFM_TIMEOUT_VALUE           180000    // 3 minutos
 
+/** @brief Intervalo entre consultas da confirmação (AT+CFS=?) depois da janela RX2 [ms] */
+#define CFM_POLL_INTERVAL           2000
+
+/** @brief Espera acordada pelo ACK, a partir do envio [ms]; depois, sem ACK, o resto do CFM_TIMEOUT_VALUE é ocioso (deep sleep) */
+#define CFM_POLL_WINDOW             15000
+
 /** @brief Intervalo mínimo entre mensagens [ms] */
 #define NEXT_MSG_TIMEOUT_VALUE      20000     // 20 segundos (teste)
 // #define NEXT_MSG_TIMEOUT_VALUE   1800000    // 30 minutos (produção)
@@ -58,6 +70,32 @@
 /** @brief Também suportado por legado: NXTMSG_TIMEOUT_VALUE */
 #define NXTMSG_TIMEOUT_VALUE        NEXT_MSG_TIMEOUT_VALUE
 
+/** @brief Intervalo entre consultas ativas do JOIN (AT+NJS) quando conectado [ms]
+ *  @note Entre as consultas vale o estado em cache (envios aceitos/recusados); a notificação de JOIN antecipa a consulta */
+#define LORA_LINK_POLL_INTERVAL     60000     // 1 minuto
+
+/** @brief Pluviômetro: chuva por báscula [um] (0,2 mm) */
+#define RAIN_TIP_UM                 200
+
+/** @brief Ciclo com chuva: intensidade na última hora [mm/h] ou acumulado em 24 h [mm] */
+#define RAIN_RATE_MM_H              5
+#define RAIN_ACC_MM                 30
+
+/** @brief Ciclo com chuva forte: intensidade na última hora [mm/h] ou acumulado em 24 h [mm] */
+#define RAIN_HEAVY_RATE_MM_H        20
+#define RAIN_HEAVY_ACC_MM           80
+
+/** @brief Ciclo máximo com chuva / chuva forte [min] (o ciclo da EEPROM vale se for menor) */
+#define RAIN_CYCLE_RAIN_MIN         5
+#define RAIN_CYCLE_HEAVY_MIN        2
+
+/** @brief Estiagem: horas sem báscula e ciclo mínimo [min] (o ciclo da EEPROM vale se for maior) */
+#define RAIN_DRY_HOURS              24
+#define RAIN_CYCLE_DRY_MIN          60
+
+/** @brief Orçamento de airtime: fração da última hora no ar [por mil] (AU915 não impõe duty cycle) */
+#define AIRTIME_DUTY_PERMIL         10        // 1% = 36 s/h
+
 // ============================================================================
 // LoRaWAN - CONFIGURAÇÃO DE TRANSMISSÃO
 // ============================================================================
@@ -78,6 +116,21 @@
 /** @brief Tamanho máximo de payload [bytes] */
 #define LORA_MAX_PAYLOAD            100
 
+/** @brief Formato do frame de uplink: 1 = ASCII hexa (v01), 2 = binário compactado (v02),
+ *         3 = lote de amostras v02 (v03) quando o data rate permitir,
+ *         4 = lote keyframe/delta (v04), 5 = até 16 nós SPendio (v05),
+ *         6 = v02 + dispersão da janela de inclinação (v06) */
+#define PAYLOAD_FRAME_FORMAT        1
+
+/** @brief Amostras guardadas na memória RTC para envio em lote (1-15) */
+#define BATCH_MAX_SAMPLES           8
+
+/** @brief Frames v04 entre keyframes forçados (limita a perda após um uplink perdido) */
+#define DELTA_KEYFRAME_INTERVAL     6
+
+/** @brief Idade máxima da amostra mais antiga antes de enviar o frame v04 incompleto [s] */
+#define DELTA_MAX_AGE               3600
+
 /** @brief Máximo de retentativas de NACK */
 #define LORA_MAX_NACK_RETRIES       9
 
@@ -101,12 +154,99 @@
 /** @brief Ativa RS485 SPendio (sensores customizados) */
 #define SENSOR_SPENDIO_ENABLED      1
 
+/** @brief SPendio: tenta o protocolo binário (frame com CRC-16) e volta ao ASCII se o sensor não responder */
+#define SPENDIO_BINARY_ENABLED      1
+
+/** @brief SPendio: varreduras entre novas tentativas do protocolo binário nos nós em ASCII */
+#define SPENDIO_BINARY_RETRY        100
+
+/** @brief Prazo da varredura dos sensores [ms]: leitura I2C (AHT + BMP280) depois dele entra como falha */
+#define SENSOR_SCAN_DEADLINE        1500
+
+/** @brief SPendio por amostragem contínua em segundo plano (média, desvio e pico a pico por janela; ESP32 sempre acordado) */
+#define TILT_SAMPLING_ENABLED       0
+
+/** @brief Intervalo entre varreduras da amostragem contínua [ms] (mínimo: tempo de uma varredura) */
+#define TILT_SAMPLE_PERIOD_MS       1000
+
+/** @brief Alarme imediato de movimento do talude (requer TILT_SAMPLING_ENABLED; antecipa o JOIN e a espera do ACK) */
+#define TILT_ALARM_ENABLED          0
+
+/** @brief Porta LoRaWAN do frame de alarme */
+#define TILT_ALARM_PORT             2
+
+/** @brief Leitura do acelerômetro SPendio em 0 g [contagens] */
+#define TILT_ACC_ZERO               512
+
+/** @brief Alarme: ângulo em relação à base [mrad] (também o passo para alarmes seguintes) */
+#define TILT_ALARM_MRAD             20
+
+/** @brief Alarme: velocidade angular [mrad/s] */
+#define TILT_ALARM_RATE             5
+
+/** @brief Alarme: histerese para voltar ao repouso [mrad] */
+#define TILT_ALARM_HYST             5
+
+/** @brief Alarme: leituras seguidas acima do limiar */
+#define TILT_ALARM_CONFIRM          3
+
+/** @brief Alarme: intervalo mínimo entre o alarme e o próximo uplink do ciclo [ms] (TX + RX1/RX2 do alarme) */
+#define TILT_ALARM_GUARD            10000
+
+/** @brief Alarme: espera para reenviar depois de um envio recusado pelo módulo [ms] */
+#define TILT_ALARM_RETRY            30000
+
+/** @brief Período de leitura dos sensores SPendio [s] (0 = toda varredura) */
+#define SENSOR_PERIOD_SPENDIO       0
+
+/** @brief Validade da leitura SPendio [s]: depois disso o valor guardado vai como falha */
+#define SENSOR_TTL_SPENDIO          0
+
+/** @brief Período de leitura de temperatura e umidade (AHT) [s] */
+#define SENSOR_PERIOD_TEMP_UMID     600
+
+/** @brief Validade da temperatura e umidade [s] */
+#define SENSOR_TTL_TEMP_UMID        3600
+
+/** @brief Período de leitura da pressão (BMP280) [s] */
+#define SENSOR_PERIOD_PRESSURE      1800
+
+/** @brief Validade da pressão [s] */
+#define SENSOR_TTL_PRESSURE         7200
+
+/** @brief Período de leitura da bateria [s] */
+#define SENSOR_PERIOD_BATTERY       3600
+
+/** @brief Validade da leitura da bateria [s] */
+#define SENSOR_TTL_BATTERY          14400
+
+/** @brief SPendio: tempo total da varredura dividido entre os nós registrados [ms] */
+#define SPENDIO_SCAN_BUDGET         1000
+
+/** @brief SPendio: prazo de resposta de cada endereço na descoberta do power-on [ms] */
+#define SPENDIO_DISCOVERY_TIMEOUT   60
+
 /** @brief Ativa sensor de chuva (GPIO) */
 #define SENSOR_RAIN_ENABLED         1
 
+/** @brief Pluviômetro pela interrupção nas bordas (debounce por tempo, DEBDmax) em vez da task de varredura de 1 ms */
+#define RAIN_USE_ISR                1
+
+/** @brief Pluviômetro contado pelo ULP (debounce no coprocessador, também em deep sleep, sem acordar a CPU a cada báscula) */
+#define RAIN_USE_ULP                ENABLE_DEEP_SLEEP
+
+/** @brief Básculas contadas pelo ULP em deep sleep que acordam o ESP32 para reavaliar a agenda da chuva (0 = só no ciclo) */
+#define RAIN_ULP_WAKE_TIPS          10
+
 /** @brief Ativa monitoramento de bateria */
 #define SENSOR_BATTERY_ENABLED      1
 
+/** @brief Bateria pelo ADC contínuo (DMA) filtrado em segundo plano em vez de 8 leituras bloqueantes */
+#define BATTERY_USE_DMA             1
+
+/** @brief Taxa do ADC contínuo [amostras/s]: 20000 (mínimo do ESP32) - 2000000 */
+#define BATTERY_SAMPLE_RATE         20000
+
 // ============================================================================
 // HARDWARE - PINOS
 // ============================================================================
@@ -141,9 +281,50 @@
 /** @brief Intervalo watchdog [ms] */
 #define WATCHDOG_TIMEOUT            30000
 
-/** @brief Reinicia automaticamente após N erros sequenciais */
+/** @brief Intervalo do registro da latência dos comandos AT no log (LOGD) [ms] */
+#define LORA_STATS_LOG_INTERVAL     3600000   // 1 hora
+
+/** @brief Reinicia automaticamente (esp_restart) após N erros sequenciais */
 #define MAX_SEQUENTIAL_ERRORS       10
 
+/** @brief Erros sequenciais para a recuperação do LoRa (reset do módulo e novo JOIN); repete a cada N */
+#define FAULT_RECOVER_AFTER         3
+
+/** @brief Atraso do reinício agendado (erros ou downlink 0x82) [ms] */
+#define FAULT_RESTART_DELAY         2000
+
+// ============================================================================
+// ENERGIA - DEEP SLEEP
+// ============================================================================
+
+/**
+ * @section POWER Energia
+ */
+
+/** @brief Deep sleep entre ciclos e na espera do ACK depois de CFM_POLL_WINDOW (estado mantido na memória RTC) */
+#define ENABLE_DEEP_SLEEP           0
+
+/** @brief Espera mínima para entrar em deep sleep [ms] (abaixo disso fica acordado) */
+#define DEEP_SLEEP_MIN_INTERVAL     10000
+
+/** @brief Modelo de consumo: corrente acordado (ESP32 + sensores) [uA] */
+#define ENERGY_ACTIVE_CURRENT_UA    45000
+
+/** @brief Modelo de consumo: corrente durante TX/RX LoRa [uA] */
+#define ENERGY_TX_CURRENT_UA        120000
+
+/** @brief Modelo de consumo: corrente em deep sleep (ESP32 + módulo LoRa + RS485) [uA] */
+#define ENERGY_SLEEP_CURRENT_UA     250
+
+/** @brief Modelo de consumo (Energia.h): tempo acordado em STATE_READY e em cada despertar (boot + leitura) [ms] */
+#define ENERGY_ACTIVE_TIME_MS       1500
+
+/** @brief Modelo de consumo (Energia.h): tempo de rádio por uplink (TX + RX1/RX2) [ms] */
+#define ENERGY_TX_TIME_MS           2500
+
+/** @brief Modelo de consumo: capacidade da bateria [mAh] */
+#define ENERGY_BATTERY_MAH          7000
+
 // ============================================================================
 // DESENVOLVIMENTO - DEBUG
 // ============================================================================
@@ -178,5 +359,9 @@
     #error "LORA_MAX_PAYLOAD inválido (10-242)"
 #endif
 
+#if ENABLE_DEEP_SLEEP && (TILT_SAMPLING_ENABLED || TILT_ALARM_ENABLED)
+    #error "TILT_SAMPLING_ENABLED e TILT_ALARM_ENABLED amostram com o ESP32 acordado: incompatíveis com ENABLE_DEEP_SLEEP"
+#endif
+
 #endif /* _CONFIG_H */
 
@@ -130,15 +130,102 @@ uint8_t Adafruit_AHTX0::getStatus(void) {
 /**************************************************************************/
 bool Adafruit_AHTX0::getEvent(sensors_event_t *humidity,
                               sensors_event_t *temp) {
-  uint32_t t = millis();
+  if (!startMeasurement()) {
+    return false;
+  }
+  return readMeasurement(humidity, temp);
+}
 
-  // read the data and store it!
+/**************************************************************************/
+/*!
+    @brief  Triggers a conversion and returns without waiting for it
+    @note   The conversion takes about 80 ms; collect the result with
+            readMeasurement() so other work can overlap the conversion
+    @returns true if the trigger command was acknowledged
+*/
+/**************************************************************************/
+bool Adafruit_AHTX0::startMeasurement(void) {
   uint8_t cmd[3] = {AHTX0_CMD_TRIGGER, 0x33, 0};
-  if (!i2c_dev->write(cmd, 3)) {
+  _trigger_time = millis();
+  return i2c_dev->write(cmd, 3);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks whether the triggered conversion has finished
+    @returns true if the sensor is no longer busy
+*/
+/**************************************************************************/
+bool Adafruit_AHTX0::measurementReady(void) {
+  return !(getStatus() & AHTX0_STATUS_BUSY);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Collects the result of the conversion started by
+            startMeasurement(), waiting only for what is left of it
+    @param  humidity Sensor event object that will be populated with humidity
+   data
+    @param  temp Sensor event object that will be populated with temp data
+    @param  timeout_ms Max time since the trigger before giving up
+    @returns true if the event data was read successfully
+*/
+/**************************************************************************/
+bool Adafruit_AHTX0::readMeasurement(sensors_event_t *humidity,
+                                     sensors_event_t *temp,
+                                     uint32_t timeout_ms) {
+  uint32_t h, tdata;
+  if (!_readRaw(&h, &tdata, timeout_ms)) {
     return false;
   }
+  _humidity = ((float)h * 100) / 0x100000;
+  _temperature = ((float)tdata * 200 / 0x100000) - 50;
 
-  while (getStatus() & AHTX0_STATUS_BUSY) {
+  // use helpers to fill in the events
+  if (temp)
+    fillTempEvent(temp, _trigger_time);
+  if (humidity)
+    fillHumidityEvent(humidity, _trigger_time);
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Same as readMeasurement() with integer conversion only (no float)
+    @param  temperature Temperature in 0.01 degrees celsius
+    @param  humidity Relative humidity in 0.1 percent
+    @param  timeout_ms Max time since the trigger before giving up
+    @returns true if the data was read successfully
+*/
+/**************************************************************************/
+bool Adafruit_AHTX0::readMeasurementInt(int32_t *temperature,
+                                        uint16_t *humidity,
+                                        uint32_t timeout_ms) {
+  uint32_t h, tdata;
+  if (!_readRaw(&h, &tdata, timeout_ms)) {
+    return false;
+  }
+  // 20-bit readings: RH = h * 100 / 2^20, T = t * 200 / 2^20 - 50
+  *humidity = (uint16_t)((h * 125) >> 17);                   // 1000 / 2^20
+  *temperature = (int32_t)((tdata * 625) >> 15) - 5000;      // 20000 / 2^20
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Waits for the conversion and reads the raw 20-bit values
+    @param  hdata Raw humidity
+    @param  tdata Raw temperature
+    @param  timeout_ms Max time since the trigger before giving up
+    @returns true if the data was read successfully
+*/
+/**************************************************************************/
+bool Adafruit_AHTX0::_readRaw(uint32_t *hdata, uint32_t *tdata,
+                              uint32_t timeout_ms) {
+  while (!measurementReady()) {
+    if (millis() - _trigger_time > timeout_ms) {
+      return false;
+    }
     delay(10);
   }
 
@@ -151,20 +238,14 @@ bool Adafruit_AHTX0::getEvent(sensors_event_t *humidity,
   h |= data[2];
   h <<= 4;
   h |= data[3] >> 4;
-  _humidity = ((float)h * 100) / 0x100000;
-
-  uint32_t tdata = data[3] & 0x0F;
-  tdata <<= 8;
-  tdata |= data[4];
-  tdata <<= 8;
-  tdata |= data[5];
-  _temperature = ((float)tdata * 200 / 0x100000) - 50;
+  *hdata = h;
 
-  // use helpers to fill in the events
-  if (temp)
-    fillTempEvent(temp, t);
-  if (humidity)
-    fillHumidityEvent(humidity, t);
+  uint32_t t = data[3] & 0x0F;
+  t <<= 8;
+  t |= data[4];
+  t <<= 8;
+  t |= data[5];
+  *tdata = t;
   return true;
 }
 
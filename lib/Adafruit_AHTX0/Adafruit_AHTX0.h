@@ -31,6 +31,7 @@
 #define AHTX0_CMD_SOFTRESET 0xBA     ///< Soft reset command
 #define AHTX0_STATUS_BUSY 0x80       ///< Status bit for busy
 #define AHTX0_STATUS_CALIBRATED 0x08 ///< Status bit for calibrated
+#define AHTX0_MEASUREMENT_TIMEOUT 200 ///< Max wait for a conversion (ms)
 
 class Adafruit_AHTX0;
 
@@ -84,6 +85,12 @@ public:
              uint8_t i2c_address = AHTX0_I2CADDR_DEFAULT);
 
   bool getEvent(sensors_event_t *humidity, sensors_event_t *temp);
+  bool startMeasurement(void);
+  bool measurementReady(void);
+  bool readMeasurement(sensors_event_t *humidity, sensors_event_t *temp,
+                       uint32_t timeout_ms = AHTX0_MEASUREMENT_TIMEOUT);
+  bool readMeasurementInt(int32_t *temperature, uint16_t *humidity,
+                          uint32_t timeout_ms = AHTX0_MEASUREMENT_TIMEOUT);
   uint8_t getStatus(void);
   Adafruit_Sensor *getTemperatureSensor(void);
   Adafruit_Sensor *getHumiditySensor(void);
@@ -92,6 +99,8 @@ protected:
   float _temperature, ///< Last reading's temperature (C)
       _humidity;      ///< Last reading's humidity (percent)
 
+  uint32_t _trigger_time = 0;  ///< millis() of the last trigger
+
   uint16_t _sensorid_humidity; ///< ID number for humidity
   uint16_t _sensorid_temp;     ///< ID number for temperature
 
@@ -102,6 +111,7 @@ protected:
       NULL; ///< Humidity sensor data object
 
 private:
+  bool _readRaw(uint32_t *hdata, uint32_t *tdata, uint32_t timeout_ms);
   void _fetchTempCalibrationValues(void);
   void _fetchHumidityCalibrationValues(void);
   friend class Adafruit_AHTX0_Temp;     ///< Gives access to private members to
@@ -242,16 +242,12 @@ void Adafruit_BMP280::readCoefficients() {
 }
 
 /*!
- * Reads the temperature from the device.
- * @return The temperature in degrees celsius.
+ * @brief Temperature compensation from the datasheet (also sets t_fine)
+ * @param adc_T Raw 20-bit temperature reading
+ * @return Temperature in 0.01 degrees celsius
  */
-float Adafruit_BMP280::readTemperature() {
+int32_t Adafruit_BMP280::compensateTemperature(int32_t adc_T) {
   int32_t var1, var2;
-  if (!_sensorID)
-    return NAN; // begin() not called yet
-
-  int32_t adc_T = read24(BMP280_REGISTER_TEMPDATA);
-  adc_T >>= 4;
 
   var1 = ((((adc_T >> 3) - ((int32_t)_bmp280_calib.dig_T1 << 1))) *
           ((int32_t)_bmp280_calib.dig_T2)) >>
@@ -265,24 +261,16 @@ float Adafruit_BMP280::readTemperature() {
 
   t_fine = var1 + var2;
 
-  float T = (t_fine * 5 + 128) >> 8;
-  return T / 100;
+  return (t_fine * 5 + 128) >> 8;
 }
 
 /*!
- * Reads the barometric pressure from the device.
- * @return Barometric pressure in Pa.
+ * @brief Pressure compensation from the datasheet (uses t_fine)
+ * @param adc_P Raw 20-bit pressure reading
+ * @return Pressure in Pa
  */
-float Adafruit_BMP280::readPressure() {
+float Adafruit_BMP280::compensatePressure(int32_t adc_P) {
   int64_t var1, var2, p;
-  if (!_sensorID)
-    return NAN; // begin() not called yet
-
-  // Must be done first to get the t_fine variable set up
-  readTemperature();
-
-  int32_t adc_P = read24(BMP280_REGISTER_PRESSUREDATA);
-  adc_P >>= 4;
 
   var1 = ((int64_t)t_fine) - 128000;
   var2 = var1 * var1 * (int64_t)_bmp280_calib.dig_P6;
@@ -305,6 +293,156 @@ float Adafruit_BMP280::readPressure() {
   return (float)p / 256;
 }
 
+/*!
+ * Reads the temperature from the device.
+ * @return The temperature in degrees celsius.
+ */
+float Adafruit_BMP280::readTemperature() {
+  if (!_sensorID)
+    return NAN; // begin() not called yet
+
+  int32_t adc_T = read24(BMP280_REGISTER_TEMPDATA);
+  adc_T >>= 4;
+
+  float T = compensateTemperature(adc_T);
+  return T / 100;
+}
+
+/*!
+ * Reads the barometric pressure from the device.
+ * @return Barometric pressure in Pa.
+ */
+float Adafruit_BMP280::readPressure() {
+  if (!_sensorID)
+    return NAN; // begin() not called yet
+
+  // Must be done first to get the t_fine variable set up
+  readTemperature();
+
+  int32_t adc_P = read24(BMP280_REGISTER_PRESSUREDATA);
+  adc_P >>= 4;
+
+  return compensatePressure(adc_P);
+}
+
+/*!
+ * @brief Pressure compensation with 32-bit integers only (datasheet 8.2)
+ * @note  1 Pa resolution; uses t_fine. From -40 to 85 degC and 300 to
+ *        1100 hPa it stays within -2/+7 Pa of compensatePressure() (the
+ *        datasheet example gives 100656 Pa against 100653.27 Pa), below the
+ *        sensor's +-12 Pa relative accuracy. See test/test_compensacao.
+ * @param adc_P Raw 20-bit pressure reading
+ * @return Pressure in Pa
+ */
+uint32_t Adafruit_BMP280::compensatePressureInt(int32_t adc_P) {
+  int32_t var1, var2;
+  uint32_t p;
+
+  var1 = (t_fine >> 1) - (int32_t)64000;
+  var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)_bmp280_calib.dig_P6);
+  var2 = var2 + ((var1 * ((int32_t)_bmp280_calib.dig_P5)) << 1);
+  var2 = (var2 >> 2) + (((int32_t)_bmp280_calib.dig_P4) << 16);
+  var1 = (((_bmp280_calib.dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) +
+          ((((int32_t)_bmp280_calib.dig_P2) * var1) >> 1)) >>
+         18;
+  var1 = ((((32768 + var1)) * ((int32_t)_bmp280_calib.dig_P1)) >> 15);
+
+  if (var1 == 0) {
+    return 0; // avoid exception caused by division by zero
+  }
+  p = (((uint32_t)(((int32_t)1048576) - adc_P) - (var2 >> 12))) * 3125;
+  if (p < 0x80000000) {
+    p = (p << 1) / ((uint32_t)var1);
+  } else {
+    p = (p / (uint32_t)var1) * 2;
+  }
+  var1 = (((int32_t)_bmp280_calib.dig_P9) *
+          ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >>
+         12;
+  var2 = (((int32_t)(p >> 2)) * ((int32_t)_bmp280_calib.dig_P8)) >> 13;
+  p = (uint32_t)((int32_t)p + ((var1 + var2 + _bmp280_calib.dig_P7) >> 4));
+  return p;
+}
+
+/*!
+ * @brief Burst-reads the raw temperature and pressure (registers 0xF7-0xFC)
+ * @note  In forced mode, waits for the conversion started by
+ *        startForcedMeasurement() to finish first
+ * @param adc_T Raw 20-bit temperature reading
+ * @param adc_P Raw 20-bit pressure reading
+ * @return true if successful, otherwise false
+ */
+bool Adafruit_BMP280::readRaw(int32_t *adc_T, int32_t *adc_P) {
+  uint8_t buffer[6];
+
+  if (!_sensorID)
+    return false; // begin() not called yet
+
+  if ((_measReg.mode == MODE_FORCED) &&
+      !waitMeasurement(BMP280_MEASUREMENT_TIMEOUT))
+    return false;
+
+  if (i2c_dev) {
+    buffer[0] = uint8_t(BMP280_REGISTER_PRESSUREDATA);
+    if (!i2c_dev->write_then_read(buffer, 1, buffer, 6))
+      return false;
+  } else {
+    buffer[0] = uint8_t(BMP280_REGISTER_PRESSUREDATA | 0x80);
+    if (!spi_dev->write_then_read(buffer, 1, buffer, 6))
+      return false;
+  }
+
+  *adc_P = (uint32_t(buffer[0]) << 16 | uint32_t(buffer[1]) << 8 |
+            uint32_t(buffer[2])) >>
+           4;
+  *adc_T = (uint32_t(buffer[3]) << 16 | uint32_t(buffer[4]) << 8 |
+            uint32_t(buffer[5])) >>
+           4;
+  return true;
+}
+
+/*!
+ * @brief Reads temperature and pressure with a single burst of registers
+ *        0xF7-0xFC and one compensation pass
+ * @param temperature Temperature in degrees celsius (may be NULL)
+ * @param pressure Barometric pressure in Pa (may be NULL)
+ * @return true if successful, otherwise false
+ */
+bool Adafruit_BMP280::readAll(float *temperature, float *pressure) {
+  int32_t adc_T, adc_P;
+
+  if (!readRaw(&adc_T, &adc_P))
+    return false;
+
+  float T = compensateTemperature(adc_T);
+  if (temperature)
+    *temperature = T / 100;
+  if (pressure)
+    *pressure = compensatePressure(adc_P);
+  return true;
+}
+
+/*!
+ * @brief Same as readAll() with 32-bit integer compensation only
+ *        (no float, no 64-bit math)
+ * @param temperature Temperature in 0.01 degrees celsius (may be NULL)
+ * @param pressure Barometric pressure in Pa (may be NULL)
+ * @return true if successful, otherwise false
+ */
+bool Adafruit_BMP280::readAllInt(int32_t *temperature, uint32_t *pressure) {
+  int32_t adc_T, adc_P;
+
+  if (!readRaw(&adc_T, &adc_P))
+    return false;
+
+  int32_t T = compensateTemperature(adc_T);
+  if (temperature)
+    *temperature = T;
+  if (pressure)
+    *pressure = compensatePressureInt(adc_P);
+  return true;
+}
+
 /*!
  * @brief Calculates the approximate altitude using barometric pressure and the
  * supplied sea level hPa as a reference.
@@ -374,6 +512,34 @@ bool Adafruit_BMP280::takeForcedMeasurement() {
   return false;
 }
 
+/*!
+    @brief  Starts a measurement in forced mode without waiting for it; the
+            sensor returns to sleep when done. Collect it with readAll().
+    @return true if the sensor is in forced mode, otherwise false
+ */
+bool Adafruit_BMP280::startForcedMeasurement() {
+  if (_measReg.mode == MODE_FORCED) {
+    write8(BMP280_REGISTER_CONTROL, _measReg.get());
+    return true;
+  }
+  return false;
+}
+
+/*!
+    @brief  Waits while a conversion is running
+    @param  timeout_ms Max wait
+    @return true if the conversion finished in time
+ */
+bool Adafruit_BMP280::waitMeasurement(uint32_t timeout_ms) {
+  uint32_t start = millis();
+  while (read8(BMP280_REGISTER_STATUS) & BMP280_STATUS_MEASURING) {
+    if (millis() - start > timeout_ms)
+      return false;
+    delay(1);
+  }
+  return true;
+}
+
 /*!
  *  @brief  Resets the chip via soft reset
  */
@@ -63,6 +63,10 @@ enum {
   BMP280_REGISTER_TEMPDATA = 0xFA,
 };
 
+#define BMP280_STATUS_MEASURING 0x08 /**< Status bit: conversion running */
+#define BMP280_MEASUREMENT_TIMEOUT                                             \
+  100 /**< Max wait for a forced conversion (ms) */
+
 /*!
  *  Struct to hold calibration data.
  */
@@ -195,6 +199,9 @@ public:
   float seaLevelForAltitude(float altitude, float atmospheric);
   float waterBoilingPoint(float pressure);
   bool takeForcedMeasurement();
+  bool startForcedMeasurement();
+  bool readAll(float *temperature, float *pressure);
+  bool readAllInt(int32_t *temperature, uint32_t *pressure);
 
   Adafruit_Sensor *getTemperatureSensor(void);
   Adafruit_Sensor *getPressureSensor(void);
@@ -245,6 +252,11 @@ private:
   };
 
   void readCoefficients(void);
+  bool waitMeasurement(uint32_t timeout_ms);
+  int32_t compensateTemperature(int32_t adc_T);
+  float compensatePressure(int32_t adc_P);
+  uint32_t compensatePressureInt(int32_t adc_P);
+  bool readRaw(int32_t *adc_T, int32_t *adc_P);
   uint8_t spixfer(uint8_t x);
   void write8(byte reg, byte value);
   uint8_t read8(byte reg);
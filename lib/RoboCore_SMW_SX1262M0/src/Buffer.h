@@ -2,7 +2,7 @@
 #define BUFFER_H
 
 /*******************************************************************************
-* RoboCore Buffer Library (v1.1)
+* RoboCore Buffer Library (v1.2)
 * 
 * Library to manipulate buffers.
 * 
@@ -28,48 +28,28 @@
 
 #define BUFFER_DEBUG
 
+// Capacity of every <Buffer> (must hold the largest response of the module)
+#define BUFFER_MAX_SIZE   70
+
 // --------------------------------------------------
 // Dependencies
 
-#ifdef BUFFER_DEBUG
-#include <Stream.h>
-#endif
-
-extern "C" {
-  #include <stdint.h>
-}
+#include "RingBuffer.h"
 
 // -----------------------------------------------------------------
 
-class Buffer {
+// NOTE: since v1.2 the buffer is a fixed capacity ring buffer. The size given
+//       in the constructor or in <resize()> is limited to BUFFER_MAX_SIZE and
+//       no dynamic memory is used.
+//  RAM: every instance takes BUFFER_MAX_SIZE + 3 bytes (73), whatever the
+//       size requested. The firmware has two: the module buffer of the driver
+//       (was 70 bytes on the heap) and the temporary of LoRaHandler::receive()
+//       (73 bytes on the stack; was a heap block of the payload size). Use a
+//       RingBuffer<N> directly for small buffers (e.g. the status line).
+class Buffer : public RingBuffer<BUFFER_MAX_SIZE> {
   public:
     Buffer();
     Buffer(uint8_t);
-    Buffer(const Buffer&);
-    ~Buffer();
-    void append(uint8_t);
-    uint8_t available(void);
-    void copy(uint8_t *);
-    bool isFull(void);
-    uint8_t peek(void);
-    uint8_t read(void);
-    void remove(uint8_t);
-    void reset(void);
-    void resize(uint8_t);
-    uint8_t size(void);
-
-    Buffer& operator=(const Buffer&);
-
-    const uint8_t& operator[](uint8_t) const;
-
-#ifdef BUFFER_DEBUG
-    void print(Stream *);
-#endif
-  
-  private:
-    uint8_t _index;
-    uint8_t _size;
-    uint8_t *_buffer;
 };
 
 // -----------------------------------------------------------------
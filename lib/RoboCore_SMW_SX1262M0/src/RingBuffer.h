@@ -0,0 +1,309 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+/*******************************************************************************
+* RoboCore Ring Buffer (v1.0)
+*
+* Fixed capacity circular buffer, with the same interface of <Buffer>.
+*
+* The storage is part of the object (no dynamic memory), so the buffers can be
+* created, copied and resized without fragmenting the heap. Reading, appending
+* and peeking are O(1).
+*
+*
+* This file is part of the SMW_SX1262M0 library ("SMW_SX1262M0-lib").
+*
+* "SMW_SX1262M0-lib" is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* "SMW_SX1262M0-lib" is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with "SMW_SX1262M0-lib". If not, see <https://www.gnu.org/licenses/>
+*******************************************************************************/
+
+#define RING_BUFFER_DEBUG
+
+// --------------------------------------------------
+// Dependencies
+
+#ifdef RING_BUFFER_DEBUG
+#include <Stream.h>
+#endif
+
+extern "C" {
+  #include <stdint.h>
+}
+
+// -----------------------------------------------------------------
+
+// Read only view of the data of a ring buffer (no copy)
+//  NOTE: the view is valid only while the buffer is not modified.
+class BufferView {
+  public:
+    BufferView() : _data(nullptr), _capacity(0), _head(0), _length(0) {}
+    BufferView(const uint8_t *data, uint8_t capacity, uint8_t head, uint8_t length) :
+      _data(data), _capacity(capacity), _head(head), _length(length) {}
+
+    // Get the quantity of bytes in the view
+    //  @returns [uint8_t]
+    uint8_t length(void) const {
+      return _length;
+    }
+
+    // Get a byte of the view
+    //  @param (index) : the index of the byte [uint8_t]
+    //  @returns the byte or 0 if out of bounds [uint8_t]
+    uint8_t operator[](uint8_t index) const {
+      if(index >= _length){
+        return 0;
+      }
+      uint16_t position = (uint16_t)_head + index;
+      if(position >= _capacity){
+        position -= _capacity; // wrap around
+      }
+      return _data[position];
+    }
+
+    // Copy the data of the view to an array
+    //  @param (data) : the array to copy to [uint8_t *]
+    //         (length) : the maximum quantity of bytes to copy [uint8_t]
+    //  @returns the quantity of bytes copied [uint8_t]
+    uint8_t copy(uint8_t *data, uint8_t length) const {
+      if(length > _length){
+        length = _length;
+      }
+      for(uint8_t i=0 ; i < length ; i++){
+        data[i] = (*this)[i];
+      }
+      return length;
+    }
+
+    // Find the first occurrence of a byte
+    //  @param (b) : the byte to search for [uint8_t]
+    //  @returns the index of the byte or the length of the view if not found [uint8_t]
+    uint8_t find(uint8_t b) const {
+      for(uint8_t i=0 ; i < _length ; i++){
+        if((*this)[i] == b){
+          return i;
+        }
+      }
+      return _length;
+    }
+
+    // Get a view of part of this view
+    //  @param (offset) : the index of the first byte [uint8_t]
+    //         (length) : the maximum quantity of bytes [uint8_t]
+    //  @returns [BufferView]
+    BufferView sub(uint8_t offset, uint8_t length = 255) const {
+      if(offset > _length){
+        offset = _length;
+      }
+      if(length > (_length - offset)){
+        length = _length - offset;
+      }
+      uint16_t head = (uint16_t)_head + offset;
+      if(head >= _capacity){
+        head -= _capacity; // wrap around
+      }
+      return BufferView(_data, _capacity, head, length);
+    }
+
+  private:
+    const uint8_t *_data;
+    uint8_t _capacity;
+    uint8_t _head;
+    uint8_t _length;
+};
+
+// -----------------------------------------------------------------
+
+// Fixed capacity circular buffer
+//  NOTE: the size of the buffer (<size()>) can be changed at runtime up to
+//        the capacity, without allocating memory.
+template <uint8_t CAPACITY>
+class RingBuffer {
+  public:
+    RingBuffer() : RingBuffer(CAPACITY) {}
+
+    // Constructor
+    //  @param (size) : the size of the buffer in bytes [uint8_t]
+    explicit RingBuffer(uint8_t size) : _head(0), _length(0) {
+      _size = _limit(size);
+    }
+
+    // Append a byte to the buffer
+    //  @param (b) the byte to append [uint8_t]
+    void append(uint8_t b){
+      if(!isFull()){
+        _data[_position(_length)] = b;
+        _length++;
+      }
+    }
+
+    // Check if there is data available
+    //  @returns the quantity of bytes stored [uint8_t]
+    uint8_t available(void) const {
+      return _length;
+    }
+
+    // Get a copy of the buffer
+    //  @param (data) : the array to copy to [uint8_t *]
+    void copy(uint8_t *data) const {
+      view().copy(data, _length);
+    }
+
+    // Check if the buffer is full
+    //  @returns [bool]
+    bool isFull(void) const {
+      return (_length >= _size);
+    }
+
+    // Check the first byte in the buffer
+    //  @returns [uint8_t]
+    uint8_t peek(void) const {
+      if(_length == 0){
+        return 0;
+      }
+      return _data[_head];
+    }
+
+#ifdef RING_BUFFER_DEBUG
+    // Print the buffer to a stream
+    //  @param (stream) : the stream to print to [Stream *]
+    void print(Stream *stream) const {
+      if(stream){
+        stream->print("\nBuffer: ");
+        stream->print(_size);
+        stream->print('|');
+        stream->print(_length); // is the same as <available()>
+        stream->print('|');
+        for(uint8_t i=0 ; i < _length ; i++){
+          stream->write(_data[_position(i)]);
+        }
+        stream->println();
+      }
+    }
+#endif
+
+    // Read the first byte in the buffer
+    //  @returns [uint8_t]
+    uint8_t read(void){
+      uint8_t ret = peek();
+      if(_length > 0){
+        _head = _position(1);
+        _length--; // update
+      }
+      return ret;
+    }
+
+    // Remove a byte from the buffer
+    //  @param (index) : the index to remove [uint8_t]
+    //  NOTE: only the shorter side of the buffer is shifted, so removing the
+    //        first or the last byte is O(1).
+    void remove(uint8_t index){
+      // check the index
+      if(index >= _length){
+        return;
+      }
+
+      if(index < (_length / 2)){
+        // shift the head side forward
+        for(uint8_t i=index ; i > 0 ; i--){
+          _data[_position(i)] = _data[_position(i - 1)];
+        }
+        _head = _position(1);
+      } else {
+        // shift the tail side backward
+        for(uint8_t i=index ; i < (_length - 1) ; i++){
+          _data[_position(i)] = _data[_position(i + 1)];
+        }
+      }
+      _length--; // update
+    }
+
+    // Reset the buffer
+    void reset(void){
+      _head = 0;
+      _length = 0;
+    }
+
+    // Resize the buffer
+    //  @param (size) : the size of the buffer in bytes [uint8_t]
+    //  NOTE: the size is limited to the capacity and the oldest data is kept.
+    void resize(uint8_t size){
+      // check the new size
+      if(size == 0){
+        return;
+      }
+
+      _size = _limit(size);
+
+      // validate the length
+      if(_length > _size){
+        _length = _size;
+      }
+    }
+
+    // Get the size of the buffer
+    //  @returns the size of the buffer in bytes [uint8_t]
+    uint8_t size(void) const {
+      return _size;
+    }
+
+    // Get a view of the data (no copy)
+    //  @returns [BufferView]
+    BufferView view(void) const {
+      return BufferView(_data, CAPACITY, _head, _length);
+    }
+
+    // Operator [] (subscript)
+    //  @returns the value of the last index if out of bounds [const uint8_t]
+    const uint8_t& operator[](uint8_t index) const {
+      static const uint8_t EMPTY = 0;
+      if(_length == 0){
+        return EMPTY;
+      }
+      // check the index
+      if(index >= _length){
+        index = _length - 1; // return from the last index
+      }
+      return _data[_position(index)];
+    }
+
+  private:
+    uint8_t _data[CAPACITY];
+    uint8_t _head;
+    uint8_t _length;
+    uint8_t _size;
+
+    // Get the position in the storage of an index
+    //  @param (index) : the index from the head [uint8_t]
+    //  @returns [uint8_t]
+    uint8_t _position(uint8_t index) const {
+      uint16_t position = (uint16_t)_head + index;
+      if(position >= CAPACITY){
+        position -= CAPACITY; // wrap around
+      }
+      return position;
+    }
+
+    // Limit a size to the capacity
+    //  @param (size) : the size to check [uint8_t]
+    //  @returns [uint8_t]
+    static uint8_t _limit(uint8_t size){
+      if(size == 0){
+        return 1; // force the minimum size
+      }
+      return (size > CAPACITY) ? CAPACITY : size;
+    }
+};
+
+// -----------------------------------------------------------------
+
+#endif // RING_BUFFER_H
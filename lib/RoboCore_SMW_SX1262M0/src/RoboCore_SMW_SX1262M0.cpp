@@ -39,20 +39,27 @@ extern "C" {
 //  @param (stream) : the stream to send the data to [Stream *]
 SMW_SX1262M0::SMW_SX1262M0(Stream &stream) :
   _stream(&stream),
-  _buffer(SMW_SX1262M0_BUFFER_SIZE)
+  _buffer(SMW_SX1262M0_BUFFER_SIZE),
+  _event_length(0),
+  _events(SMW_SX1262M0_EVENT_NONE)
   {
 #ifdef SMW_SX1262M0_DEBUG
     _stream_debug = nullptr;
 #endif
+#ifdef SMW_SX1262M0_STATISTICS
+    _last_command = CMD_AT;
+    reset_statistics();
+#endif
 }
 
 // --------------------------------------------------
 // --------------------------------------------------
 
 // Flush the buffered data in the stream
+//  NOTE: the data is still checked for unsolicited notifications (see <listen()>)
 void SMW_SX1262M0::flush(void){
   while(_stream->available()){
-    _stream->read();
+    _parse_event(_stream->read());
   }
 }
 
@@ -519,6 +526,47 @@ CommandResponse SMW_SX1262M0::get_SNR(float (&snr)){
 
 // --------------------------------------------------
 
+#ifdef SMW_SX1262M0_STATISTICS
+// Get the latency statistics of a command
+//  @param (command) : the command to search for (ex: CMD_NJS, or CMD_AT for <ping()>) [char *]
+//         (statistics) : the variable to store the result [SMW_SX1262M0_Statistics (&)]
+//  @returns true if the command was found [bool]
+bool SMW_SX1262M0::get_statistics(const char *command, SMW_SX1262M0_Statistics (&statistics)){
+  if(command == nullptr){
+    command = CMD_AT;
+  }
+
+  for(uint8_t i=0 ; i < SMW_SX1262M0_STATISTICS_SIZE ; i++){
+    if(_statistics[i].command == nullptr){
+      break; // end of the used entries
+    }
+    if(strcmp(_statistics[i].command, command) == 0){
+      statistics = _statistics[i];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// --------------------------------------------------
+
+// Get the latency statistics by index (to iterate over all the commands)
+//  @param (index) : the index of the entry [uint8_t]
+//         (statistics) : the variable to store the result [SMW_SX1262M0_Statistics (&)]
+//  @returns true if the entry is in use [bool]
+bool SMW_SX1262M0::get_statistics_at(uint8_t index, SMW_SX1262M0_Statistics (&statistics)){
+  if((index >= SMW_SX1262M0_STATISTICS_SIZE) || (_statistics[index].command == nullptr)){
+    return false;
+  }
+
+  statistics = _statistics[index];
+  return true;
+}
+#endif
+
+// --------------------------------------------------
+
 // Get the Version
 //  @param (version) : the array to store the result [uint8_t[n]]
 //  @returns the type of the response [CommandResponse]
@@ -631,6 +679,22 @@ CommandResponse SMW_SX1262M0::join(void){
 
 // --------------------------------------------------
 
+// Listen for unsolicited notifications of the module (join)
+//  @returns the events received since the last call [uint8_t]
+//  NOTE: the notifications received during other commands are also reported.
+//  NOTE: it doesn't wait for data, so it can be called on every loop.
+uint8_t SMW_SX1262M0::listen(void){
+  while(_stream->available()){
+    _parse_event(_stream->read());
+  }
+
+  uint8_t events = _events;
+  _events = SMW_SX1262M0_EVENT_NONE; // reset
+  return events;
+}
+
+// --------------------------------------------------
+
 // Listen for incoming data in the P2P communication (LoRa Test)
 //  @param (timeout) : the time to wait, in [ms] [uint32_t]
 //  @returns the type of the response [CommandResponse]
@@ -871,32 +935,31 @@ CommandResponse SMW_SX1262M0::readT(Buffer (&buffer)){
 CommandResponse SMW_SX1262M0::readT(uint8_t (&port), Buffer (&buffer)){
   CommandResponse res = readT(); // read the message
 
-  // parse the message
-  uint8_t b;
-  bool payload = false;
-  char sport[4]; // 0 to 999
+  // parse the message (without copying the internal buffer)
+  BufferView data = _buffer.view();
+  uint8_t delimitter = data.find(CHAR_COLON);
+
+  // parse the port
+  char sport[4] = { CHAR_EOS }; // 0 to 999
   uint8_t index = 0;
-  while (_buffer.available()){
-    b = _buffer.read();
-
-    // check for delimitter
-    if(b == CHAR_COLON){
-      payload = true; // set
-      buffer.resize(_buffer.available()); // resize the buffer
-      continue;
+  for(uint8_t i=0 ; i < delimitter ; i++){
+    uint8_t b = data[i];
+    if((index < 3) && isdigit(b)){
+      sport[index++] = b;
+      sport[index] = CHAR_EOS;
     }
+  }
+  port = atoi(sport); // convert
 
-    // parse
-    if(!payload){
-      if((index < 3) && isdigit(b)){
-        sport[index++] = b;
-        sport[index] = CHAR_EOS;
-      }
-    } else {
-      buffer.append(b);
+  // store the payload
+  if(delimitter < data.length()){
+    BufferView payload = data.sub(delimitter + 1);
+    buffer.resize(payload.length()); // resize the buffer
+    for(uint8_t i=0 ; i < payload.length() ; i++){
+      buffer.append(payload[i]);
     }
   }
-  port = atoi(sport); // convert
+  _buffer.reset(); // the data was consumed
 
   return res;
 }
@@ -930,32 +993,31 @@ CommandResponse SMW_SX1262M0::readX(Buffer (&buffer)){
 CommandResponse SMW_SX1262M0::readX(uint8_t (&port), Buffer (&buffer)){
   CommandResponse res = readX(); // read the message
 
-  // parse the message
-  uint8_t b;
-  bool payload = false;
-  char sport[4]; // 0 to 999
+  // parse the message (without copying the internal buffer)
+  BufferView data = _buffer.view();
+  uint8_t delimitter = data.find(CHAR_COLON);
+
+  // parse the port
+  char sport[4] = { CHAR_EOS }; // 0 to 999
   uint8_t index = 0;
-  while (_buffer.available()){
-    b = _buffer.read();
-
-    // check for delimitter
-    if(b == CHAR_COLON){
-      payload = true; // set
-      buffer.resize(_buffer.available()); // resize the buffer
-      continue;
+  for(uint8_t i=0 ; i < delimitter ; i++){
+    uint8_t b = data[i];
+    if((index < 3) && isdigit(b)){
+      sport[index++] = b;
+      sport[index] = CHAR_EOS;
     }
+  }
+  port = atoi(sport); // convert
 
-    // parse
-    if(!payload){
-      if((index < 3) && isdigit(b)){
-        sport[index++] = b;
-        sport[index] = CHAR_EOS;
-      }
-    } else {
-      buffer.append(b);
+  // store the payload
+  if(delimitter < data.length()){
+    BufferView payload = data.sub(delimitter + 1);
+    buffer.resize(payload.length()); // resize the buffer
+    for(uint8_t i=0 ; i < payload.length() ; i++){
+      buffer.append(payload[i]);
     }
   }
-  port = atoi(sport); // convert
+  _buffer.reset(); // the data was consumed
 
   return res;
 }
@@ -1033,6 +1095,22 @@ CommandResponse SMW_SX1262M0::reset(void){
 
 // --------------------------------------------------
 
+#ifdef SMW_SX1262M0_STATISTICS
+// Reset the latency statistics
+void SMW_SX1262M0::reset_statistics(void){
+  for(uint8_t i=0 ; i < SMW_SX1262M0_STATISTICS_SIZE ; i++){
+    _statistics[i].command = nullptr;
+    _statistics[i].count = 0;
+    _statistics[i].timeouts = 0;
+    _statistics[i].last = 0;
+    _statistics[i].max = 0;
+    _statistics[i].total = 0;
+  }
+}
+#endif
+
+// --------------------------------------------------
+
 // Save the current configuration
 //  @returns the type of the response [CommandResponse]
 CommandResponse SMW_SX1262M0::save(void){
@@ -1445,10 +1523,20 @@ void SMW_SX1262M0::_delay(uint32_t duration){
 CommandResponse SMW_SX1262M0::_read_response(uint32_t timeout){
   _buffer.reset(); // reset for storing the new response
   
+  // parser of the status line
+  // NOTE: the status is returned as "<CR><LF>Status<CR><LF>", so the reading
+  //       can stop as soon as a known status is found in a complete line,
+  //       instead of waiting for the whole timeout.
+  char line[SMW_SX1262M0_SIZE_STATUS + 1];
+  uint8_t line_length = 0;
+  bool line_open = false; // a line can only be a status after a <LF>
+  bool line_cr = false; // <CR> received, waiting for <LF>
+  bool complete = false;
+  
   // read the incoming data
   uint8_t c;
-  uint32_t stop_time = millis() + timeout;
-  while(millis() < stop_time){
+  uint32_t start_time = millis();
+  while(!complete && ((millis() - start_time) < timeout)){
     if(_stream->available()){
       c = _stream->read(); // read the incoming byte
       
@@ -1465,10 +1553,36 @@ CommandResponse SMW_SX1262M0::_read_response(uint32_t timeout){
       }
 #endif
 
+      _parse_event(c); // notifications can arrive in the middle of the response
+
       if((c > 31) && (c < 127)){
         _buffer.append(c);
-      } else if((c == CHAR_CR) || (c == CHAR_LF)){
+
+        // store the line while it can still be a status
+        if(line_open){
+          if(line_length < SMW_SX1262M0_SIZE_STATUS){
+            line[line_length++] = c;
+          } else {
+            line_open = false; // too long for a status
+          }
+        }
+        line_cr = false; // reset
+      } else if(c == CHAR_CR){
+        _buffer.append(c);
+        line_cr = true; // set
+      } else if(c == CHAR_LF){
         _buffer.append(c);
+
+        // check for the end of a status line
+        if(line_open && line_cr && (line_length > 0)){
+          line[line_length] = CHAR_EOS;
+          complete = _is_status(line, line_length);
+        }
+
+        // start a new line
+        line_open = true;
+        line_length = 0;
+        line_cr = false;
       }
     } else {
 #if defined(ARDUINO_ESP8266_GENERIC) || defined(ARDUINO_ESP8266_NODEMCU) || defined(ARDUINO_ESP8266_THING) || defined(ARDUINO_ESP32_DEV)
@@ -1480,8 +1594,12 @@ CommandResponse SMW_SX1262M0::_read_response(uint32_t timeout){
     }
   }
 
+#ifdef SMW_SX1262M0_STATISTICS
+  _update_statistics(millis() - start_time, complete);
+#endif
+
   // get the status of the message
-  Buffer buffer_status(25);
+  RingBuffer<SMW_SX1262M0_SIZE_STATUS + 1> buffer_status;
   uint8_t buffer_length = _buffer.available();
   if(buffer_length > 4){ // (the status is returned as "<CR><LF>Status<CR><LF>")
     uint8_t status = 0;
@@ -1593,6 +1711,43 @@ CommandResponse SMW_SX1262M0::_read_response(uint32_t timeout){
 
 // --------------------------------------------------
 
+// Check if a line is a status message
+//  @param (line) : the line to check [char *]
+//         (length) : the length of the line [uint8_t]
+//  @returns true if the line is one of the known status messages [bool]
+bool SMW_SX1262M0::_is_status(const char *line, uint8_t length){
+  const char* const STATUS[] = { RSPNS_OK, RSPNS_ERROR, RSPNS_ERROR_BUSY, RSPNS_ERROR_PARAMETER,
+                                 RSPNS_ERROR_PARAMETER_OVERFLOW, RSPNS_NO_NETWORK };
+  for(uint8_t i=0 ; i < (sizeof(STATUS) / sizeof(STATUS[0])) ; i++){
+    if((strlen(STATUS[i]) == length) && (memcmp(line, STATUS[i], length) == 0)){
+      return true;
+    }
+  }
+  return false;
+}
+
+// --------------------------------------------------
+
+// Parse a byte for unsolicited notifications
+//  @param (c) : the byte received [uint8_t]
+void SMW_SX1262M0::_parse_event(uint8_t c){
+  if((c == CHAR_CR) || (c == CHAR_LF)){
+    // check the line (exact match, longer lines were discarded)
+    if((_event_length == strlen(EVT_JOINED)) && (memcmp(_event_line, EVT_JOINED, _event_length) == 0)){
+      _events |= SMW_SX1262M0_EVENT_JOINED;
+    }
+    _event_length = 0; // reset
+  } else if((c > 31) && (c < 127)){
+    if(_event_length < SMW_SX1262M0_SIZE_EVENT){
+      _event_line[_event_length++] = c;
+    } else {
+      _event_length = SMW_SX1262M0_SIZE_EVENT + 1; // too long: never matches
+    }
+  }
+}
+
+// --------------------------------------------------
+
 // Send a command to the module
 //  @param (command) : the command to send [char *]
 //         (action)  : the type of action for the command [CommandAction]
@@ -1600,6 +1755,9 @@ CommandResponse SMW_SX1262M0::_read_response(uint32_t timeout){
 //         (...)     : optional and variable data to send [char *]
 void SMW_SX1262M0::_send_command(const char *command, CommandAction action, uint8_t qty, ...){
   flush(); // flush the data before sendig the command
+#ifdef SMW_SX1262M0_STATISTICS
+  _last_command = (command) ? command : CMD_AT; // for the latency of the response
+#endif
   // (it could be done in <readResponse()>, but it might flush some data in some cases - not verified)
   
 #ifdef SMW_SX1262M0_DEBUG
@@ -1689,6 +1847,42 @@ void SMW_SX1262M0::_send_command(const char *command, CommandAction action, uint
   _stream->write(CHAR_CR);
 }
 
+// --------------------------------------------------
+
+#ifdef SMW_SX1262M0_STATISTICS
+// Update the latency statistics of the last command
+//  @param (latency) : the time to read the response, in [ms] [uint32_t]
+//         (complete) : true if the status line was found [bool]
+void SMW_SX1262M0::_update_statistics(uint32_t latency, bool complete){
+  // find the entry of the command (or the first free entry)
+  SMW_SX1262M0_Statistics *entry = nullptr;
+  for(uint8_t i=0 ; i < SMW_SX1262M0_STATISTICS_SIZE ; i++){
+    if(_statistics[i].command == nullptr){
+      entry = &_statistics[i];
+      entry->command = _last_command; // use this entry
+      break;
+    }
+    if(strcmp(_statistics[i].command, _last_command) == 0){
+      entry = &_statistics[i];
+      break;
+    }
+  }
+  if(entry == nullptr){
+    return; // table full
+  }
+
+  entry->count++;
+  if(!complete){
+    entry->timeouts++;
+  }
+  entry->last = latency;
+  if(latency > entry->max){
+    entry->max = latency;
+  }
+  entry->total += latency;
+}
+#endif
+
 // --------------------------------------------------
 // --------------------------------------------------
 
@@ -27,6 +27,7 @@
 *******************************************************************************/
 
 #define SMW_SX1262M0_DEBUG					1
+#define SMW_SX1262M0_STATISTICS             1
 
 #define SMW_SX1262M0_BUFFER_SIZE            70
 #define SMW_SX1262M0_DELAY_INCOMING_DATA    10 // [ms]
@@ -34,6 +35,10 @@
 #define SMW_SX1262M0_TIMEOUT_RESET        3000 // [ms]
 #define SMW_SX1262M0_TIMEOUT_WRITE         500 // [ms]
 
+#define SMW_SX1262M0_SIZE_STATUS            24 // longest status line ("AT_TEST_PARAM_OVERFLOW") + margin
+#define SMW_SX1262M0_SIZE_EVENT             24 // longest event line stored
+#define SMW_SX1262M0_STATISTICS_SIZE        16 // number of commands tracked
+
 
 // --------------------------------------------------
 // Libraries
@@ -48,6 +53,10 @@ extern "C" {
 
 #include "Buffer.h"
 
+#if SMW_SX1262M0_BUFFER_SIZE > BUFFER_MAX_SIZE
+#error "SMW_SX1262M0_BUFFER_SIZE must fit in BUFFER_MAX_SIZE"
+#endif
+
 
 // --------------------------------------------------
 // Constants
@@ -110,6 +119,12 @@ const char* const RSPNS_ERROR_PARAMETER = "AT_PARAM_ERROR";
 const char* const RSPNS_ERROR_PARAMETER_OVERFLOW = "AT_TEST_PARAM_OVERFLOW";
 const char* const RSPNS_NO_NETWORK = "AT_NO_NETWORK_JOINED";
 
+// Unsolicited notifications of the module
+// NOTE: only whole lines are matched. The notifications are not part of the
+//       documented AT command set, so an event is just a hint to poll the
+//       module again (ex: AT+NJS=?), never a state by itself.
+const char* const EVT_JOINED = "JOINED";
+
 
 // --------------------------------------------------
 // Constants
@@ -132,6 +147,9 @@ const char* const RSPNS_NO_NETWORK = "AT_NO_NETWORK_JOINED";
 #define SMW_SX1262M0_TX_STATUS_NOT_CONFIRMED 0
 #define SMW_SX1262M0_TX_STATUS_CONFIRMED     1
 
+#define SMW_SX1262M0_EVENT_NONE         0x00
+#define SMW_SX1262M0_EVENT_JOINED       0x01
+
 enum class CommandAction : uint8_t { RUN , GET , SET , HELP };
 enum class CommandResponse : uint8_t { OK , ERROR , BUSY , NO_NETWORK , DATA };
 
@@ -148,6 +166,23 @@ enum class CommandResponse : uint8_t { OK , ERROR , BUSY , NO_NETWORK , DATA };
 #define SMW_SX1262M0_SIZE_VERSION    3
 
 
+// --------------------------------------------------
+// Statistics
+
+#ifdef SMW_SX1262M0_STATISTICS
+// Latency of the responses of a command
+//  NOTE: the latency is measured from the end of the command to the status line
+struct SMW_SX1262M0_Statistics {
+  const char *command; // the command ("AT" for <ping()>)
+  uint16_t count; // quantity of responses read
+  uint16_t timeouts; // quantity of responses without a status line
+  uint32_t last; // [ms]
+  uint32_t max; // [ms]
+  uint32_t total; // [ms]
+};
+#endif
+
+
 // --------------------------------------------------
 // Class
 
@@ -171,10 +206,15 @@ class SMW_SX1262M0 {
     CommandResponse get_NwkSKey(char (&)[SMW_SX1262M0_SIZE_NWKSKEY]);
     CommandResponse get_RSSI(float (&));
     CommandResponse get_SNR(float (&));
+#ifdef SMW_SX1262M0_STATISTICS
+    bool get_statistics(const char *, SMW_SX1262M0_Statistics (&));
+    bool get_statistics_at(uint8_t, SMW_SX1262M0_Statistics (&));
+#endif
     CommandResponse get_Version(uint8_t (&)[SMW_SX1262M0_SIZE_VERSION]);
     bool isConnected(void);
     bool isConfirmed(void);
     CommandResponse join(void);
+    uint8_t listen(void);
     CommandResponse P2P_listen(uint32_t, Buffer (&));
     CommandResponse P2P_listen(uint32_t, Buffer (&), float (&), float (&));
     CommandResponse P2P_start(uint32_t = 915200, bool = false, const char * = nullptr);
@@ -203,6 +243,10 @@ class SMW_SX1262M0 {
     CommandResponse set_JoinMode(uint8_t);
     CommandResponse set_NwkSKey(const char *);
 
+#ifdef SMW_SX1262M0_STATISTICS
+    void reset_statistics(void);
+#endif
+
 #ifdef SMW_SX1262M0_DEBUG
     void set_debugger(Stream *);
 #endif
@@ -215,7 +259,19 @@ class SMW_SX1262M0 {
     Stream* _stream_debug;
 #endif
 
+#ifdef SMW_SX1262M0_STATISTICS
+    const char *_last_command;
+    SMW_SX1262M0_Statistics _statistics[SMW_SX1262M0_STATISTICS_SIZE];
+    void _update_statistics(uint32_t, bool);
+#endif
+
+    char _event_line[SMW_SX1262M0_SIZE_EVENT + 1];
+    uint8_t _event_length;
+    uint8_t _events;
+
     void _delay(uint32_t);
+    bool _is_status(const char *, uint8_t);
+    void _parse_event(uint8_t);
     CommandResponse _read_response(uint32_t);
     void _send_command(const char *,CommandAction, uint8_t = 0, ...);
 };
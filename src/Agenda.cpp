@@ -0,0 +1,168 @@
+/**
+ * @file Agenda.cpp
+ * @brief Implementação do intervalo adaptado à chuva e do orçamento de airtime
+ * @copyright Copyright (c) 2025
+ */
+
+#include <Arduino.h>
+#include "config.h"
+#include "Logger.h"
+#include "Chuva.h"
+#include "PowerManager.h"
+#include "Agenda.h"
+
+static_assert(RAIN_DRY_HOURS >= 1, "RAIN_DRY_HOURS inválido");
+static_assert((AIRTIME_DUTY_PERMIL >= 1) && (AIRTIME_DUTY_PERMIL <= 1000), "AIRTIME_DUTY_PERMIL fora de 1..1000");
+
+#define AIRTIME_ORCAMENTO   (3600UL * AIRTIME_DUTY_PERMIL)   // airtime por hora [ms]
+
+/**
+ * @brief Soma móvel em N compartimentos de PASSO segundos
+ * @details ultimo é o índice absoluto (tempo / PASSO) do compartimento atual;
+ *          os que saem da janela são zerados ao avançar.
+ */
+template <uint8_t N, uint32_t PASSO>
+struct Janela_Type {
+  uint32_t ultimo;
+  uint32_t v[N];
+
+  void avanca(uint32_t agora) {
+    uint32_t k = agora / PASSO;
+    if ((k - ultimo) >= N) memset(v, 0, sizeof(v));   // janela inteira vencida (ou relógio voltou)
+    else while (ultimo != k) v[++ultimo % N] = 0;
+    ultimo = k;
+  }
+
+  void soma(uint32_t agora, uint32_t x) {
+    avanca(agora);
+    v[ultimo % N] += x;
+  }
+
+  uint32_t total(uint32_t agora) {
+    uint32_t t = 0;
+    avanca(agora);
+    for (uint8_t i = 0; i < N; i++) t += v[i];
+    return t;
+  }
+};
+
+// Mantidos durante o deep sleep; zerados no power-on/reset
+RTC_DATA_ATTR static Janela_Type<12, 300> s_chuvaHora;    // básculas, compartimentos de 5 min
+RTC_DATA_ATTR static Janela_Type<24, 3600> s_chuvaDia;    // básculas, compartimentos de 1 h
+RTC_DATA_ATTR static Janela_Type<12, 300> s_airtime;      // [ms], compartimentos de 5 min
+RTC_DATA_ATTR static bool s_iniciada;
+RTC_DATA_ATTR static int16_t s_contAnterior;              // contChuva já somado
+RTC_DATA_ATTR static uint32_t s_ultimaBascula;            // [s]
+RTC_DATA_ATTR static uint32_t s_inicioCiclo;              // [ms]
+RTC_DATA_ATTR static uint32_t s_ultimoAirtime;            // estimativa do próximo uplink [ms]
+RTC_DATA_ATTR static uint8_t s_nivel = AGENDA_BASE;
+
+static const char *const NIVEL[] = { "estiagem", "base", "chuva", "chuva forte" };
+
+/**
+ * @brief Segundos do relógio RTC
+ */
+static uint32_t agora(void) {
+  return PowerManager::rtcSegundos();
+}
+
+/**
+ * @brief Marca o início do ciclo
+ */
+void agendaInicioCiclo(void) {
+  s_inicioCiclo = PowerManager::rtcMillis();
+}
+
+/**
+ * @brief Básculas novas nas janelas de chuva
+ */
+void agendaChuva(void) {
+  uint32_t t = agora();
+
+  if (!s_iniciada) {                        // estiagem só após RAIN_DRY_HOURS observadas
+    s_iniciada = true;
+    s_contAnterior = contChuva;
+    s_ultimaBascula = t;
+    return;
+  }
+
+  uint16_t novas = (uint16_t)(contChuva - s_contAnterior);
+  s_contAnterior = contChuva;
+  if (novas == 0) return;
+
+  s_chuvaHora.soma(t, novas);
+  s_chuvaDia.soma(t, novas);
+  s_ultimaBascula = t;
+}
+
+/**
+ * @brief Airtime de um uplink
+ */
+void agendaUplink(uint32_t airtime) {
+  s_airtime.soma(agora(), airtime);
+  s_ultimoAirtime = airtime;
+}
+
+/**
+ * @brief Nível de chuva das janelas
+ */
+static uint8_t nivelChuva(uint32_t t) {
+  uint32_t intensidade = s_chuvaHora.total(t) * RAIN_TIP_UM;       // última hora [um/h]
+  uint32_t acumulado = s_chuvaDia.total(t) * RAIN_TIP_UM;          // 24 h [um]
+
+  if ((intensidade >= RAIN_HEAVY_RATE_MM_H * 1000UL) || (acumulado >= RAIN_HEAVY_ACC_MM * 1000UL)) return AGENDA_CHUVA_FORTE;
+  if ((intensidade >= RAIN_RATE_MM_H * 1000UL) || (acumulado >= RAIN_ACC_MM * 1000UL)) return AGENDA_CHUVA;
+  if ((t - s_ultimaBascula) >= RAIN_DRY_HOURS * 3600UL) return AGENDA_ESTIAGEM;
+  return AGENDA_BASE;
+}
+
+/**
+ * @brief Espera para o orçamento de airtime comportar o próximo uplink
+ * @return uint32_t 0 se cabe agora; senão até o compartimento que libera espaço sair da janela [ms]
+ */
+static uint32_t esperaAirtime(uint32_t t) {
+  uint32_t usado = s_airtime.total(t);
+  if (usado + s_ultimoAirtime <= AIRTIME_ORCAMENTO) return 0;
+
+  // Compartimentos saem da janela do mais antigo (j = 11) ao atual (j = 0)
+  uint32_t liberado = 0;
+  uint8_t j = 11;
+  for (;; j--) {
+    liberado += s_airtime.v[(s_airtime.ultimo + 12 - j) % 12];
+    if ((usado - liberado + s_ultimoAirtime <= AIRTIME_ORCAMENTO) || (j == 0)) break;
+  }
+  return ((s_airtime.ultimo - j + 12) * 300UL - t) * 1000UL;
+}
+
+/**
+ * @brief Espera até a próxima varredura
+ */
+uint32_t agendaEspera(uint8_t cicloMin) {
+  atualizaChuva();
+  agendaChuva();
+
+  uint32_t t = agora();
+  uint8_t nivel = nivelChuva(t);
+  uint32_t ciclo = cicloMin;                                        // [min]
+
+  if ((nivel == AGENDA_CHUVA_FORTE) && (ciclo > RAIN_CYCLE_HEAVY_MIN)) ciclo = RAIN_CYCLE_HEAVY_MIN;
+  else if ((nivel == AGENDA_CHUVA) && (ciclo > RAIN_CYCLE_RAIN_MIN)) ciclo = RAIN_CYCLE_RAIN_MIN;
+  else if ((nivel == AGENDA_ESTIAGEM) && (ciclo < RAIN_CYCLE_DRY_MIN)) ciclo = RAIN_CYCLE_DRY_MIN;
+  ciclo *= 60000UL;                                                 // [ms]
+
+  if (nivel != s_nivel) {
+    LOGI("COMM", "Agenda: %s -> %s (ciclo %lu min)", NIVEL[s_nivel], NIVEL[nivel], (unsigned long)(ciclo / 60000UL));
+    s_nivel = nivel;
+  }
+
+  uint32_t decorrido = PowerManager::rtcMillis() - s_inicioCiclo;
+  uint32_t espera = (decorrido < ciclo) ? ciclo - decorrido : 0;
+
+  uint32_t airtime = esperaAirtime(t);
+  if (airtime > espera) {
+    LOGW("COMM", "Orçamento de airtime: %lu/%lu ms na última hora, espera %lu s",
+         (unsigned long)s_airtime.total(t), (unsigned long)AIRTIME_ORCAMENTO, (unsigned long)(airtime / 1000));
+    espera = airtime;
+  }
+  return (espera < NEXT_MSG_TIMEOUT_VALUE) ? NEXT_MSG_TIMEOUT_VALUE : espera;
+}
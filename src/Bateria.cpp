@@ -0,0 +1,248 @@
+/*
+  --------------------------------------------------------------------------------
+                                                              Início: 17/10/2026
+        Proj.:  WCPendio - Sistema de monitoramento de Taludes e Encostas
+        Fonte:  Bateria.cpp
+        Progs:  Eng. Prof. Nuncio Perrella, MSc e Arnaldo
+        Descr.: Monitor da bateria - ADC contínuo (DMA) com filtro
+                mediana das médias e queda de tensão no TX LoRa
+                                                              Última: 17/10/2026
+  --------------------------------------------------------------------------------
+        Diario de Bordo
+        ---------------
+  17/10/2026 - ADC contínuo (antes: 8 x analogReadMilliVolts em leSenBateria)
+  17/10/2026 - Leitura direta quando o ADC contínuo não inicia
+
+*/
+
+#include "Aplic.h"
+#include "config.h"
+#include "Logger.h"
+#include "Bateria.h"
+#if BATTERY_USE_DMA
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#endif
+
+RTC_DATA_ATTR static uint16_t s_quedaTX;    // última queda no TX [mV]
+
+//------------------------------------------------------------------------------
+//  leituraDireta - Média de 8 leituras analogReadMilliVolts (~8 ms)
+//
+static uint16_t leituraDireta(void) {
+  int32_t soma = 0;
+  for (int i = 0; i < 8; i++) {
+    soma += analogReadMilliVolts(aVBat);
+    delay(1);                               // 1 ms
+  }
+  return (uint16_t)(soma >> 3);             // média de 8
+}
+
+#if BATTERY_USE_DMA
+
+#define BAT_CANAL        ADC1_CHANNEL_3     // aVBat (GPIO39)
+#define BAT_GRUPOS       8                  // médias por bloco (mediana entre elas)
+#define BAT_POR_GRUPO    32                 // amostras por média
+#define BAT_BLOCO        (BAT_GRUPOS * BAT_POR_GRUPO)
+#define BAT_ANEL         16                 // valores filtrados recentes
+#define BAT_VREF         1100               // Vref padrão sem calibração no eFuse [mV]
+
+static esp_adc_cal_characteristics_t s_carac;
+static TaskHandle_t s_taskBat = NULL;
+static bool s_dma;                          // ADC contínuo ativo (senão, leitura direta)
+
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool s_valido;                       // já há um bloco filtrado
+static uint16_t s_mv;                       // último valor filtrado [mV]
+static uint16_t s_anel[BAT_ANEL];           // valores filtrados recentes [mV]
+static uint8_t s_posAnel;
+static uint8_t s_quantAnel;
+static bool s_emTX;                         // entre bateriaInicioTX e bateriaFimTX
+static uint16_t s_nivelTX;                  // nível antes do TX [mV]
+static uint16_t s_minTX;                    // mínimo durante o TX [mV]
+static uint32_t s_inicioTX;                 // [ms]
+
+//------------------------------------------------------------------------------
+//  medianaMedias - Mediana de BAT_GRUPOS médias (ordenação por inserção)
+//
+static uint16_t medianaMedias(uint16_t *m) {
+  for (uint8_t i = 1; i < BAT_GRUPOS; i++) {
+    uint16_t v = m[i];
+    uint8_t j = i;
+    for (; (j > 0) && (m[j - 1] > v); j--) m[j] = m[j - 1];
+    m[j] = v;
+  }
+  return (m[BAT_GRUPOS / 2 - 1] + m[BAT_GRUPOS / 2] + 1) / 2;
+}
+
+//------------------------------------------------------------------------------
+//  publica - Novo valor filtrado: último valor, anel e mínimo do TX
+//
+static void publica(uint16_t mv) {
+  portENTER_CRITICAL(&s_mux);
+  s_mv = mv;
+  s_valido = true;
+  s_anel[s_posAnel] = mv;
+  s_posAnel = (s_posAnel + 1) % BAT_ANEL;
+  if (s_quantAnel < BAT_ANEL) s_quantAnel++;
+  if (s_emTX && (mv < s_minTX) && ((millis() - s_inicioTX) < ENERGY_TX_TIME_MS)) s_minTX = mv;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+//------------------------------------------------------------------------------
+//  vTaskBateria - Consome o DMA do ADC e filtra blocos de BAT_BLOCO amostras
+//
+//  Cada grupo de BAT_POR_GRUPO amostras vira uma média; a mediana das
+//  BAT_GRUPOS médias descarta grupos atingidos por picos (comutação do
+//  rádio, RS485) sem o custo de ordenar o bloco inteiro.
+//
+static void vTaskBateria(void *pvParameters) {
+  uint8_t buf[BAT_BLOCO * SOC_ADC_DIGI_RESULT_BYTES];
+  uint16_t medias[BAT_GRUPOS];
+  uint32_t soma = 0;
+  uint8_t n = 0;                            // amostras no grupo
+  uint8_t g = 0;                            // grupos no bloco
+
+  for (;;) {
+    uint32_t tam = 0;
+    esp_err_t r = adc_digi_read_bytes(buf, sizeof(buf), &tam, 1000);
+    if ((r != ESP_OK) && (r != ESP_ERR_INVALID_STATE)) continue;   // INVALID_STATE: DMA transbordou, dados válidos
+
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= tam; i += SOC_ADC_DIGI_RESULT_BYTES) {
+      const adc_digi_output_data_t *d = (const adc_digi_output_data_t *)&buf[i];
+      if (d->type1.channel != BAT_CANAL) continue;
+      soma += d->type1.data;
+      if (++n < BAT_POR_GRUPO) continue;
+
+      medias[g++] = (uint16_t)((soma + BAT_POR_GRUPO / 2) / BAT_POR_GRUPO);
+      soma = 0;
+      n = 0;
+      if (g < BAT_GRUPOS) continue;
+
+      g = 0;
+      publica((uint16_t)esp_adc_cal_raw_to_voltage(medianaMedias(medias), &s_carac));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//  iniBateria - Calibração (eFuse) e ADC contínuo no canal da bateria
+//
+void iniBateria(void) {
+  if (s_taskBat != NULL) return;
+  s_dma = false;
+
+  esp_adc_cal_value_t cal = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, BAT_VREF, &s_carac);
+  LOGI("SENSOR", "VBAT: calibração %s", (cal == ESP_ADC_CAL_VAL_EFUSE_TP) ? "eFuse (two point)"
+                                        : (cal == ESP_ADC_CAL_VAL_EFUSE_VREF) ? "eFuse (Vref)" : "Vref padrão");
+
+  adc_digi_init_config_t ini = {
+    .max_store_buf_size = 4 * SOC_ADC_DIGI_RESULT_BYTES * BAT_BLOCO,
+    .conv_num_each_intr = SOC_ADC_DIGI_RESULT_BYTES * BAT_BLOCO,
+    .adc1_chan_mask = BIT(BAT_CANAL),
+    .adc2_chan_mask = 0,
+  };
+  adc_digi_pattern_config_t padrao = {
+    .atten = ADC_ATTEN_DB_11,
+    .channel = BAT_CANAL,
+    .unit = 0,                              // ADC1
+    .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+  };
+  adc_digi_configuration_t cfg = {
+    .conv_limit_en = true,                  // obrigatório no ESP32
+    .conv_limit_num = 250,
+    .pattern_num = 1,
+    .adc_pattern = &padrao,
+    .sample_freq_hz = BATTERY_SAMPLE_RATE,
+    .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+    .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+  };
+
+  if ((adc_digi_initialize(&ini) != ESP_OK) || (adc_digi_controller_configure(&cfg) != ESP_OK)) {
+    LOGE("SENSOR", "VBAT: ADC contínuo indisponível, usando leitura direta");
+    adc_digi_deinitialize();
+    return;
+  }
+  if (xTaskCreate(vTaskBateria, "BAT", configMINIMAL_STACK_SIZE + 2048, NULL, 1, &s_taskBat) != pdPASS) {
+    LOGE("SENSOR", "VBAT: sem memória para a task, usando leitura direta");
+    s_taskBat = NULL;
+    adc_digi_deinitialize();
+    return;
+  }
+  adc_digi_start();
+  s_dma = true;
+}
+
+//------------------------------------------------------------------------------
+//  bateriaMilliVolts - Último valor filtrado (falso antes do primeiro bloco)
+//
+//  Sem o ADC contínuo, lê direto (sem queda no TX).
+//
+bool bateriaMilliVolts(uint16_t &mv) {
+  if (!s_dma) {
+    mv = leituraDireta();
+    return true;
+  }
+  portENTER_CRITICAL(&s_mux);
+  bool ok = s_valido;
+  mv = s_mv;
+  portEXIT_CRITICAL(&s_mux);
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+//  bateriaInicioTX - Nível de referência antes do rádio (média do anel)
+//
+//  O mínimo é acompanhado por ENERGY_TX_TIME_MS (TX + RX1/RX2).
+//
+void bateriaInicioTX(void) {
+  portENTER_CRITICAL(&s_mux);
+  uint32_t soma = 0;
+  for (uint8_t i = 0; i < s_quantAnel; i++) soma += s_anel[i];
+  s_emTX = (s_quantAnel > 0);
+  s_nivelTX = s_emTX ? (uint16_t)(soma / s_quantAnel) : 0;
+  s_minTX = s_nivelTX;
+  s_inicioTX = millis();
+  portEXIT_CRITICAL(&s_mux);
+}
+
+//------------------------------------------------------------------------------
+//  bateriaFimTX - Encerra o acompanhamento e devolve a queda [mV] (0: sem TX)
+//
+uint16_t bateriaFimTX(void) {
+  portENTER_CRITICAL(&s_mux);
+  bool emTX = s_emTX;
+  uint16_t queda = s_nivelTX - s_minTX;     // s_minTX <= s_nivelTX
+  s_emTX = false;
+  portEXIT_CRITICAL(&s_mux);
+
+  if (!emTX) return 0;
+  s_quedaTX = queda;
+  return queda;
+}
+
+#else
+
+void iniBateria(void) {
+}
+
+bool bateriaMilliVolts(uint16_t &mv) {
+  mv = leituraDireta();
+  return true;
+}
+
+void bateriaInicioTX(void) {
+}
+
+uint16_t bateriaFimTX(void) {
+  return 0;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+//  bateriaQuedaTX - Queda de tensão medida no último TX [mV]
+//
+uint16_t bateriaQuedaTX(void) {
+  return s_quedaTX;
+}
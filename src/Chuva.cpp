@@ -0,0 +1,401 @@
+/*
+  --------------------------------------------------------------------------------
+                                                              Início: 16/12/2023
+        Proj.:  WCPendio - Sistema de monitoramento de Taludes e Encostas
+        Fonte:  Chuva.cpp
+        Progs:  Eng. Prof. Nuncio Perrella, MSc e Arnaldo
+        Descr.: Pluviômetro (báscula) - contagem no ULP (também em deep
+                sleep), interrupção nas bordas com debounce por tempo ou task
+                de varredura
+                                                              Última: 17/10/2026
+  --------------------------------------------------------------------------------
+        Diario de Bordo
+        ---------------
+  16/12/2023 - Sensor de chuva (task de varredura, Sensores.cpp)
+  17/10/2026 - Contador PCNT + despertar por GPIO (EXT0)
+  17/10/2026 - PCNT substituído pela interrupção com debounce por tempo
+               (o filtro do PCNT, até 12,8 us, não rejeita o repique do reed)
+  17/10/2026 - Contagem e debounce no ULP: a báscula não acorda mais o
+               ESP32 em deep sleep (só a cada RAIN_ULP_WAKE_TIPS)
+
+*/
+
+#include "Aplic.h"
+#include "config.h"
+#include "Logger.h"
+#include "PowerManager.h"
+#include <esp_sleep.h>
+#if RAIN_USE_ULP
+#include <esp32/ulp.h>
+#include <driver/rtc_io.h>
+#include <soc/rtc_io_reg.h>
+#include <soc/soc.h>
+#elif RAIN_USE_ISR
+#include <freertos/timers.h>
+#endif
+
+RTC_DATA_ATTR int16_t contChuva;            // mantido durante o deep sleep
+
+#if RAIN_USE_ULP
+
+#if !CONFIG_ESP32_ULP_COPROC_ENABLED
+#error "RAIN_USE_ULP requer o ULP habilitado no sdkconfig (CONFIG_ESP32_ULP_COPROC_ENABLED)"
+#endif
+
+#define ULP_PERIODO_US   2000               // leitura do pino pelo ULP
+#define ULP_DEB          (DEBDmax * 1000 / ULP_PERIODO_US)       // leituras estáveis para aceitar a borda
+#define ULP_DIAG         (TEMPO_DIAG * 1000 / ULP_PERIODO_US)    // leituras acionada: modo diagnóstico
+
+// Variáveis do ULP: palavras no início da RTC_SLOW_MEM (reservada ao ULP), 16 bits baixos
+enum {
+  ULP_CONT = 0,                             // básculas contadas (só o ULP escreve; volta em 65536)
+  ULP_NIVEL,                                // nível estável do pino (0 = acionada)
+  ULP_DEB_CONT,                             // leituras seguidas diferentes do nível estável
+  ULP_TEMPO,                                // leituras com a báscula acionada (saturado em ULP_DIAG)
+  ULP_DIAG_VISTO,                           // acionamento longo (o ULP só escreve 1)
+  ULP_FALTAM,                               // básculas até acordar o ESP32 (0 = não acorda)
+  ULP_VARS,
+  ULP_PROG = 8                              // início do programa [palavras]
+};
+
+static_assert(ULP_DEB > 0, "DEBDmax menor que o período do ULP");
+static_assert(CONFIG_ESP32_ULP_COPROC_RESERVE_MEM >= 4 * (ULP_PROG + 64), "memória do ULP insuficiente");
+
+RTC_DATA_ATTR static uint16_t s_ulpLidas;   // ULP_CONT já somado em contChuva
+
+//------------------------------------------------------------------------------
+//  ulpLe - Variável do ULP (o ULP grava o PC nos 16 bits altos)
+//
+static inline uint16_t ulpLe(uint8_t v) {
+  return (uint16_t)(RTC_SLOW_MEM[v] & 0xFFFF);
+}
+
+//------------------------------------------------------------------------------
+//  pinoULP - nChuva como RTC GPIO (o pinMode do iniHW devolve o pino ao GPIO)
+//
+static void pinoULP(void) {
+  rtc_gpio_init((gpio_num_t)nChuva);                            // pull-up externo
+  rtc_gpio_set_direction((gpio_num_t)nChuva, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_pullup_dis((gpio_num_t)nChuva);
+  rtc_gpio_pulldown_dis((gpio_num_t)nChuva);
+}
+
+//------------------------------------------------------------------------------
+//  iniULP - Carrega e inicia o programa do ULP
+//
+//  A cada ULP_PERIODO_US: lê nChuva (RTC GPIO) e aceita a mudança depois de
+//  ULP_DEB leituras seguidas iguais (o repique do reed dura milissegundos).
+//  A soltura conta uma báscula, salvo se a báscula ficou acionada por mais
+//  de TEMPO_DIAG (modo diagnóstico: acorda o ESP32). Com ULP_FALTAM > 0,
+//  a báscula que o zera acorda o ESP32.
+//
+static void iniULP(void) {
+  enum { L_IGUAL, L_TEMPO, L_ACIONOU, L_LONGO, L_FIM };
+  const int rtcio = rtc_io_number_get((gpio_num_t)nChuva);
+
+  const ulp_insn_t programa[] = {
+    I_MOVI(R3, 0),                                              // base das variáveis
+    I_RD_REG(RTC_GPIO_IN_REG, RTC_GPIO_IN_NEXT_S + rtcio, RTC_GPIO_IN_NEXT_S + rtcio),
+    I_LD(R1, R3, ULP_NIVEL),
+    I_SUBR(R2, R0, R1),
+    M_BXZ(L_IGUAL),                                             // igual ao nível estável
+
+    I_LD(R0, R3, ULP_DEB_CONT),                                 // diferente: repique ou mudança
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, ULP_DEB_CONT),
+    M_BL(L_TEMPO, ULP_DEB),
+
+    I_MOVI(R0, 0),                                              // mudança estável
+    I_ST(R0, R3, ULP_DEB_CONT),
+    I_MOVI(R0, 1),
+    I_SUBR(R1, R0, R1),                                         // novo nível
+    I_ST(R1, R3, ULP_NIVEL),
+    I_MOVR(R0, R1),
+    M_BL(L_ACIONOU, 1),
+
+    I_LD(R0, R3, ULP_TEMPO),                                    // soltura
+    M_BGE(L_LONGO, ULP_DIAG),
+    I_LD(R0, R3, ULP_CONT),
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, ULP_CONT),
+    I_LD(R0, R3, ULP_FALTAM),
+    M_BL(L_FIM, 1),                                             // sem despertar pedido
+    I_SUBI(R0, R0, 1),
+    I_ST(R0, R3, ULP_FALTAM),
+    M_BGE(L_FIM, 1),
+    I_WAKE(),
+    I_HALT(),
+
+    M_LABEL(L_LONGO),                                           // modo diagnóstico
+    I_MOVI(R0, 1),
+    I_ST(R0, R3, ULP_DIAG_VISTO),
+    I_WAKE(),
+    I_HALT(),
+
+    M_LABEL(L_ACIONOU),                                         // acionamento: conta o tempo do zero
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_TEMPO),
+    I_HALT(),
+
+    M_LABEL(L_IGUAL),                                           // repique terminou sem mudança
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_DEB_CONT),
+
+    M_LABEL(L_TEMPO),                                           // acionada: tempo saturado em ULP_DIAG
+    I_LD(R0, R3, ULP_NIVEL),
+    M_BGE(L_FIM, 1),
+    I_LD(R0, R3, ULP_TEMPO),
+    M_BGE(L_FIM, ULP_DIAG),
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, ULP_TEMPO),
+
+    M_LABEL(L_FIM),
+    I_HALT(),
+  };
+
+  for (uint8_t v = 0; v < ULP_VARS; v++) RTC_SLOW_MEM[v] = 0;
+  RTC_SLOW_MEM[ULP_NIVEL] = rtc_gpio_get_level((gpio_num_t)nChuva);
+  s_ulpLidas = 0;
+
+  size_t tam = sizeof(programa) / sizeof(ulp_insn_t);
+  if ((ulp_process_macros_and_load(ULP_PROG, programa, &tam) != ESP_OK) ||
+      (ulp_set_wakeup_period(0, ULP_PERIODO_US) != ESP_OK) || (ulp_run(ULP_PROG) != ESP_OK)) {
+    LOGE("SENSOR", "Chuva: ULP não iniciou");
+  }
+}
+
+#elif RAIN_USE_ISR
+
+RTC_DATA_ATTR static bool s_acordaNaSoltura; // dormiu com a báscula acionada
+
+static TimerHandle_t s_tmrEstavel = NULL;   // DEBDmax após a última borda
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t s_tBorda;          // última borda [ms]
+static volatile uint16_t s_basculas;        // básculas ainda não somadas em contChuva
+static bool s_pressionado;                  // estado estável da báscula
+static uint32_t s_tPressao;                 // início do acionamento estável [ms]
+
+//------------------------------------------------------------------------------
+//  isrChuva - Interrupção nas bordas de nChuva
+//
+//  Não classifica a borda: o nível lido durante o repique não é confiável.
+//  Só marca o tempo e reinicia o temporizador; a rajada de repique inteira
+//  termina em um único onChuvaEstavel.
+//
+static void IRAM_ATTR isrChuva(void) {
+  BaseType_t acorda = pdFALSE;
+
+  s_tBorda = millis();
+  xTimerResetFromISR(s_tmrEstavel, &acorda);
+  if (acorda) portYIELD_FROM_ISR();
+}
+
+//------------------------------------------------------------------------------
+//  onChuvaEstavel - DEBDmax sem bordas: nChuva estável (task dos temporizadores)
+//
+//  A transição vale no fim da rajada. Acionamento mais curto que DEBDmax
+//  some junto com o repique; soltura após mais de TEMPO_DIAG acionada é
+//  o modo diagnóstico e não conta como chuva.
+//
+static void onChuvaEstavel(TimerHandle_t) {
+  bool acionada = temChuva();
+  if (acionada == s_pressionado) return;            // repique ou ruído sem mudança
+
+  uint32_t tBorda = s_tBorda;
+  s_pressionado = acionada;
+  if (acionada) {                                   // acionamento
+    s_tPressao = tBorda;
+    ligWLED();
+  }
+  else {                                            // soltura
+    if ((tBorda - s_tPressao) > TEMPO_DIAG) g_bDiag = true;   // Modo diagnóstico
+    else {
+      portENTER_CRITICAL(&s_mux);
+      s_basculas++;
+      portEXIT_CRITICAL(&s_mux);
+    }
+    desWLED();
+  }
+}
+
+#else
+
+RTC_DATA_ATTR static bool s_acordaNaSoltura; // dormiu com a báscula acionada
+static t_eChuvaEstado eChuvaEstado = E_CHUVA_REPOUSO;
+static uint cdeb;                           // contador debounce
+TaskHandle_t taskVarreSensorChuvaHandle = NULL;
+
+#endif
+
+//------------------------------------------------------------------------------
+//  iniChuva - Inicializa o pluviômetro
+//
+void iniChuva(void) {
+  if (!PowerManager::isWarmBoot()) contChuva = 0;   // Inicializa contador de chuva
+
+#if RAIN_USE_ULP
+  pinoULP();
+  if (!PowerManager::isWarmBoot()) iniULP();        // no deep sleep o ULP continuou contando
+  RTC_SLOW_MEM[ULP_FALTAM] = 0;                     // acordado: sem despertar pelo ULP
+#elif RAIN_USE_ISR
+  // Báscula já acionada (ex.: despertou por ela): o acionamento começou no boot
+  s_pressionado = temChuva();
+  s_tPressao = 0;
+  s_tBorda = 0;
+  s_basculas = 0;
+
+  s_tmrEstavel = xTimerCreate("CHUVA", pdMS_TO_TICKS(DEBDmax), pdFALSE, NULL, onChuvaEstavel);
+  attachInterrupt(digitalPinToInterrupt(nChuva), isrChuva, CHANGE);
+#else
+  xTaskCreate(vTaskVarreSensorChuva, "SENSOR CHUVA", configMINIMAL_STACK_SIZE + 1024, NULL, 1, &taskVarreSensorChuvaHandle);
+  eChuvaEstado = E_CHUVA_INICIA;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  atualizaChuva - Transfere as básculas da interrupção (ou do ULP) para contChuva
+//
+void atualizaChuva(void) {
+#if RAIN_USE_ULP
+  uint16_t cont = ulpLe(ULP_CONT);                  // o ULP nunca é zerado pela CPU: sem corrida
+  contChuva += (int16_t)(uint16_t)(cont - s_ulpLidas);
+  s_ulpLidas = cont;
+  if (ulpLe(ULP_DIAG_VISTO)) {
+    RTC_SLOW_MEM[ULP_DIAG_VISTO] = 0;
+    g_bDiag = true;                                 // Modo diagnóstico
+  }
+#elif RAIN_USE_ISR
+  portENTER_CRITICAL(&s_mux);
+  uint16_t basculas = s_basculas;
+  s_basculas = 0;
+  portEXIT_CRITICAL(&s_mux);
+
+  contChuva += (int16_t)basculas;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  preparaSonoChuva - Habilita o despertar pelo pluviômetro (EXT0 ou ULP)
+//
+void preparaSonoChuva(void) {
+  atualizaChuva();
+
+#if RAIN_USE_ULP
+  // O ULP conta durante o sono; acorda a cada RAIN_ULP_WAKE_TIPS básculas (agenda da chuva)
+  pinoULP();
+  RTC_SLOW_MEM[ULP_FALTAM] = RAIN_ULP_WAKE_TIPS;
+  esp_sleep_enable_ulp_wakeup();
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);   // RTC GPIO lido pelo ULP
+#else
+  // Báscula acionada: acorda na soltura (é ela que conta), senão no acionamento
+  s_acordaNaSoltura = temChuva();
+  esp_sleep_enable_ext0_wakeup((gpio_num_t)nChuva, s_acordaNaSoltura ? 1 : 0);
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  contaChuvaAcordar - Conta a báscula que despertou o ESP32
+//
+//  Retorna true se o pulso foi contado e o sistema pode voltar a dormir;
+//  false em pressionamento longo (TEMPO_DIAG), tratado após o boot normal.
+//
+bool contaChuvaAcordar(void) {
+#if RAIN_USE_ULP
+  // Básculas já contadas pelo ULP: o diagnóstico fica para atualizaChuva após o boot normal
+  RTC_SLOW_MEM[ULP_FALTAM] = 0;
+  bool diag = ulpLe(ULP_DIAG_VISTO);
+  if (!diag) atualizaChuva();
+  return !diag;
+#else
+  bool soltando = false;
+  uint32_t tSoltura = 0;
+  uint32_t tPressao = 0;                    // acordou no acionamento: começou no boot
+  bool acionada = !s_acordaNaSoltura;
+
+  if (s_acordaNaSoltura) {                  // dormiu acionada: a soltura completa a báscula
+    s_acordaNaSoltura = false;
+    contChuva++;
+  }
+
+  // Aguarda a soltura estável (um repique acordaria o ESP32 de novo)
+  while (true) {
+    if (temChuva()) {
+      if (!acionada) {                              // novo acionamento (não é repique da soltura)
+        acionada = true;
+        tPressao = millis();
+      }
+      soltando = false;
+      if ((millis() - tPressao) > TEMPO_DIAG) return false;   // pressionamento longo: diagnóstico
+    }
+    else if (!soltando) {
+      soltando = true;
+      tSoltura = millis();
+    }
+    else if ((millis() - tSoltura) >= DEBDmax) break;
+    delay(1);
+  }
+
+  if (acionada) contChuva++;
+  return true;
+#endif
+}
+
+#if !RAIN_USE_ISR && !RAIN_USE_ULP
+//------------------------------------------------------------------------------
+//  vTaskVarreSensorChuva - Task de Varredura do Sensor de chuva
+//
+void vTaskVarreSensorChuva(void *pvParameters)
+{
+  int cont = 0;
+  TickType_t xLastWakeTime;
+  xLastWakeTime = xTaskGetTickCount();
+  while (1)
+  {
+    switch (eChuvaEstado) {
+      case E_CHUVA_REPOUSO:
+        break;
+      case E_CHUVA_INICIA:
+        cdeb = DEBDmax;
+        eChuvaEstado = E_CHUVA_TEM;
+        break;
+      case E_CHUVA_TEM:                         // Tem chuva?
+        if (!temChuva()) {
+          if (cdeb) cdeb--;                     // não, aguarda depressionar
+          else desWLED();
+        }
+        else {
+          if (!cdeb) {
+            cdeb = DEBPmax;                     // Sim há uma possibilidade de Chuva...
+            eChuvaEstado = E_CHUVA_ESTAB;
+          }
+          else cdeb = DEBDmax;                  // Ruído, reinicia debouncing
+        }
+        break;
+      case E_CHUVA_ESTAB:                       // Chuva estável?
+        if (temChuva()) {
+          if (cdeb) cdeb--;                     // aguarda debouncing
+          else {
+            ligWLED();
+            eChuvaEstado = E_CHUVA_ANALISE;     // Sim...
+          }
+        }
+        else {
+          cdeb = DEBPmax;                       // Ruído, reinicia debouncing
+        }
+        break;
+      case E_CHUVA_ANALISE:
+        if (temChuva()) {
+          cdeb++;
+        }
+        else {
+          if (cdeb > TEMPO_DIAG) g_bDiag = true;  // Modo diagnóstico
+          else contChuva++;                       // incrementa contador
+          eChuvaEstado = E_CHUVA_INICIA;          // reinicia...
+        }
+        break;
+    }
+    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(1));
+  }
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file Energia.cpp
+ * @brief Implementação do modelo de consumo
+ * @copyright Copyright (c) 2025
+ */
+
+#include "config.h"
+#include "Energia.h"
+
+static_assert(CFM_POLL_WINDOW > ENERGY_TX_TIME_MS, "CFM_POLL_WINDOW menor que o tempo de rádio");
+static_assert(CFM_TIMEOUT_VALUE >= CFM_POLL_WINDOW, "CFM_TIMEOUT_VALUE menor que CFM_POLL_WINDOW");
+
+/**
+ * @brief Espera ociosa: dorme (com um boot no fim) se passar de DEEP_SLEEP_MIN_INTERVAL
+ */
+static void espera(Energia_Ciclo_Type &c, uint32_t ms, bool deepSleep, bool acorda) {
+  if (deepSleep && (ms >= DEEP_SLEEP_MIN_INTERVAL)) {
+    uint32_t boot = acorda ? ENERGY_ACTIVE_TIME_MS : 0;       // o boot do ciclo seguinte já está em ativoMs
+    if (boot > ms) boot = ms;
+    c.sonoMs += ms - boot;
+    c.ativoMs += boot;
+  } else {
+    c.ativoMs += ms;
+  }
+}
+
+/**
+ * @brief Fases do ciclo
+ */
+Energia_Ciclo_Type energiaCiclo(uint32_t cicloMs, bool ack, bool deepSleep) {
+  Energia_Ciclo_Type c = { ENERGY_ACTIVE_TIME_MS, ENERGY_TX_TIME_MS, 0 };
+
+  // STATE_WAIT_CFM: consultas acordado; sem ACK, espera ociosa até o timeout e um boot
+  if (ack) {
+    c.ativoMs += CFM_POLL_INTERVAL;                             // pior caso: ACK na consulta seguinte ao fim da RX2
+  } else {
+    c.ativoMs += CFM_POLL_WINDOW - ENERGY_TX_TIME_MS;
+    espera(c, CFM_TIMEOUT_VALUE - CFM_POLL_WINDOW, deepSleep, true);
+  }
+
+  // Ciclo menor que as fases: o próximo começa logo (agendaEspera() conta desde o início do ciclo)
+  uint32_t usado = c.ativoMs + c.txMs + c.sonoMs;
+  if (usado >= cicloMs) return c;
+
+  // Resto do ciclo (STATE_READY)
+  espera(c, cicloMs - usado, deepSleep, false);
+  return c;
+}
+
+/**
+ * @brief Corrente média
+ */
+uint32_t energiaCorrenteMedia(const Energia_Ciclo_Type &ciclo) {
+  uint64_t total = (uint64_t)ciclo.ativoMs + ciclo.txMs + ciclo.sonoMs;
+  if (total == 0) return 0;
+
+  uint64_t carga = (uint64_t)ENERGY_ACTIVE_CURRENT_UA * ciclo.ativoMs       // [uA.ms]
+                 + (uint64_t)ENERGY_TX_CURRENT_UA * ciclo.txMs
+                 + (uint64_t)ENERGY_SLEEP_CURRENT_UA * ciclo.sonoMs;
+  return (uint32_t)(carga / total);
+}
+
+/**
+ * @brief Autonomia
+ */
+uint32_t energiaAutonomiaDias(uint32_t correnteUa) {
+  return correnteUa ? (uint32_t)((uint64_t)ENERGY_BATTERY_MAH * 1000ULL / correnteUa / 24) : 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file Falhas.cpp
+ * @brief Implementação do gerenciador de falhas
+ * @copyright Copyright (c) 2025
+ */
+
+#include <Arduino.h>
+#include <esp_system.h>
+#include "config.h"
+#include "Logger.h"
+#include "Falhas.h"
+
+static_assert(FAULT_RECOVER_AFTER >= 1, "FAULT_RECOVER_AFTER inválido");
+static_assert(MAX_SEQUENTIAL_ERRORS > FAULT_RECOVER_AFTER, "MAX_SEQUENTIAL_ERRORS deve passar de FAULT_RECOVER_AFTER");
+
+#define FALHAS_MAGICO   0x46414C31          // "FAL1": registro válido
+
+struct Registro_Falhas_Type {
+  uint32_t magico;
+  uint16_t reinicios;                       // desde o power-on
+  uint8_t causa;                            // t_eReinicio do último boot
+  uint8_t pendente;                         // causa gravada antes do esp_restart (REINICIO_QUANT: nenhuma)
+  uint16_t total[FALHA_QUANT];              // por classe, desde o power-on
+};
+
+// Sobrevive ao reinício por software/watchdog (validado pelo mágico)
+RTC_NOINIT_ATTR static Registro_Falhas_Type s_reg;
+
+// Mantido no deep sleep; zerado no reinício (que é a última recuperação)
+RTC_DATA_ATTR static uint8_t s_seguidas;
+
+static int8_t s_tmrReinicio = -1;
+static int8_t s_tmrRecupera = -1;
+
+static const char *const NOME_FALHA[] = { "LoRa TX", "LoRa CFM", "LoRa módulo", "estado" };
+static const char *const NOME_REINICIO[] = { "energia", "falhas", "pedido", "watchdog", "pânico", "tensão", "externo" };
+
+static_assert(sizeof(NOME_FALHA) / sizeof(NOME_FALHA[0]) == FALHA_QUANT, "NOME_FALHA incompleto");
+static_assert(sizeof(NOME_REINICIO) / sizeof(NOME_REINICIO[0]) == REINICIO_QUANT, "NOME_REINICIO incompleto");
+
+/**
+ * @brief Reinício agendado
+ */
+static void onReinicio(void *arg) {
+  (void)arg;
+  LOGE("SYSTEM", "Reiniciando (%s)", NOME_REINICIO[s_reg.pendente]);
+  Serial.flush();
+  esp_restart();
+}
+
+/**
+ * @brief Causa do boot pelo registro do ESP32
+ */
+static uint8_t causaBoot(esp_reset_reason_t r) {
+  switch (r) {
+    case ESP_RST_SW:
+      return (s_reg.pendente < REINICIO_QUANT) ? s_reg.pendente : (uint8_t)REINICIO_EXTERNO;
+    case ESP_RST_EXT:
+      return REINICIO_EXTERNO;
+    case ESP_RST_PANIC:
+      return REINICIO_PANICO;
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+      return REINICIO_WATCHDOG;
+    case ESP_RST_BROWNOUT:
+      return REINICIO_TENSAO;
+    default:
+      return REINICIO_ENERGIA;
+  }
+}
+
+/**
+ * @brief Causa do boot e temporizadores
+ */
+void iniFalhas(void) {
+  esp_reset_reason_t r = esp_reset_reason();
+
+  if ((s_reg.magico != FALHAS_MAGICO) || (r == ESP_RST_POWERON)) {   // power-on: memória sem registro
+    memset(&s_reg, 0, sizeof(s_reg));
+    s_reg.magico = FALHAS_MAGICO;
+    s_reg.pendente = REINICIO_QUANT;
+  }
+
+  if (r != ESP_RST_DEEPSLEEP) {                                     // volta do deep sleep não é reinício
+    s_reg.causa = causaBoot(r);
+    if ((r != ESP_RST_POWERON) && (s_reg.reinicios < 0xFFFF)) s_reg.reinicios++;
+    LOGI("SYSTEM", "Boot: %s (reinícios %u; falhas: TX %u, CFM %u, módulo %u, estado %u)",
+         NOME_REINICIO[s_reg.causa], (unsigned)s_reg.reinicios,
+         (unsigned)s_reg.total[FALHA_LORA_TX], (unsigned)s_reg.total[FALHA_LORA_CFM],
+         (unsigned)s_reg.total[FALHA_LORA_MODULO], (unsigned)s_reg.total[FALHA_ESTADO]);
+  }
+  s_reg.pendente = REINICIO_QUANT;                                  // o temporizador não sobrevive ao boot
+
+  s_tmrReinicio = temporizadorCria(onReinicio);
+}
+
+/**
+ * @brief Recuperação registrada
+ */
+void falhasRecuperacao(Temporizador_Cb cb) {
+  if (s_tmrRecupera < 0) s_tmrRecupera = temporizadorCria(cb);
+}
+
+/**
+ * @brief Registra uma falha
+ */
+void falhaRegistra(t_eFalha falha) {
+  if (falha >= FALHA_QUANT) return;
+
+  if (s_reg.total[falha] < 0xFFFF) s_reg.total[falha]++;
+  if (s_seguidas < 0xFF) s_seguidas++;
+  LOGW("SYSTEM", "Falha %s (%u seguidas)", NOME_FALHA[falha], (unsigned)s_seguidas);
+
+  if (s_seguidas >= MAX_SEQUENTIAL_ERRORS) {
+    falhasReinicia(REINICIO_FALHAS, FAULT_RESTART_DELAY);
+  }
+  else if ((s_seguidas % FAULT_RECOVER_AFTER) == 0) {
+    temporizadorArma(s_tmrRecupera, millis());                  // no próximo passo do loop
+  }
+}
+
+/**
+ * @brief Zera as falhas seguidas
+ */
+void falhasLimpa(void) {
+  s_seguidas = 0;
+}
+
+/**
+ * @brief Agenda o reinício
+ */
+void falhasReinicia(t_eReinicio causa, uint32_t atraso) {
+  if (s_reg.pendente < REINICIO_QUANT) return;                    // já agendado
+
+  LOGE("SYSTEM", "Reinício agendado em %lu ms (%s)", (unsigned long)atraso, NOME_REINICIO[causa]);
+  s_reg.pendente = causa;
+  temporizadorArma(s_tmrReinicio, millis() + atraso);
+}
+
+/**
+ * @brief Causa do último reinício
+ */
+t_eReinicio falhasCausaReinicio(void) {
+  return (t_eReinicio)s_reg.causa;
+}
+
+/**
+ * @brief Reinícios desde o power-on
+ */
+uint16_t falhasReinicios(void) {
+  return s_reg.reinicios;
+}
+
+/**
+ * @brief Total de uma classe
+ */
+uint16_t falhasTotal(t_eFalha falha) {
+  return (falha < FALHA_QUANT) ? s_reg.total[falha] : 0;
+}
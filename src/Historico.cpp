@@ -0,0 +1,56 @@
+/**
+ * @file Historico.cpp
+ * @brief Implementação da fila de amostras na memória RTC
+ * @copyright Copyright (c) 2025
+ */
+
+#include <Arduino.h>
+#include "config.h"
+#include "Historico.h"
+
+// Mantidos durante o deep sleep; zerados no power-on/reset
+RTC_DATA_ATTR static Registro_Amostra_Type s_registros[BATCH_MAX_SAMPLES];
+RTC_DATA_ATTR static uint8_t s_inicio;
+RTC_DATA_ATTR static uint8_t s_quant;
+
+/**
+ * @brief Acrescenta uma amostra
+ */
+void historicoAdiciona(const CPendio_Amostra_Type &amostra, uint32_t tempo) {
+  if (s_quant == BATCH_MAX_SAMPLES) historicoDescarta(1);   // perde a mais antiga
+
+  Registro_Amostra_Type &r = s_registros[(s_inicio + s_quant) % BATCH_MAX_SAMPLES];
+  r.tempo = tempo;
+  r.amostra = amostra;
+  s_quant++;
+}
+
+/**
+ * @brief Quantidade de amostras
+ */
+uint8_t historicoQuant(void) {
+  return s_quant;
+}
+
+/**
+ * @brief Capacidade da fila
+ */
+uint8_t historicoCapacidade(void) {
+  return BATCH_MAX_SAMPLES;
+}
+
+/**
+ * @brief Lê uma amostra
+ */
+const Registro_Amostra_Type &historicoLe(uint8_t i) {
+  return s_registros[(s_inicio + i) % BATCH_MAX_SAMPLES];
+}
+
+/**
+ * @brief Descarta as amostras mais antigas
+ */
+void historicoDescarta(uint8_t n) {
+  if (n > s_quant) n = s_quant;
+  s_inicio = (s_inicio + n) % BATCH_MAX_SAMPLES;
+  s_quant -= n;
+}
@@ -0,0 +1,374 @@
+/*
+  --------------------------------------------------------------------------------
+                                                              Início: 17/10/2026
+        Proj.:  WCPendio - Sistema de monitoramento de Taludes e Encostas
+        Fonte:  Inclinacao.cpp
+        Progs:  Eng. Prof. Nuncio Perrella, MSc e Arnaldo
+        Descr.: Amostragem contínua dos SPendio - estatística por janela
+                (média/variância de Welford, mínimo, máximo, pico a pico)
+                e detector de movimento (alarme imediato)
+                                                              Última: 17/10/2026
+  --------------------------------------------------------------------------------
+        Diario de Bordo
+        ---------------
+  17/10/2026 - Janela de amostragem (antes: uma leitura por ciclo)
+  17/10/2026 - Detector de inclinação: ângulo em relação à base, taxa e histerese
+
+*/
+
+#include "Aplic.h"
+#include "config.h"
+#include "Logger.h"
+#include "Inclinacao.h"
+
+#if TILT_ALARM_ENABLED && !TILT_SAMPLING_ENABLED
+#error "TILT_ALARM_ENABLED requer TILT_SAMPLING_ENABLED"
+#endif
+
+#if TILT_SAMPLING_ENABLED
+
+#define TILT_EIXOS     3                    // X, Y, Z
+#define TILT_Q         8                    // média em ponto fixo Q8
+
+// Estatística de um eixo (Welford): média Q8, soma dos quadrados dos desvios Q16
+struct Eixo_Estat_Type {
+  int32_t media;
+  int64_t m2;
+  uint16_t min;
+  uint16_t max;
+};
+
+struct No_Estat_Type {
+  uint16_t n;                               // leituras na janela
+  Eixo_Estat_Type eixo[TILT_EIXOS];
+  uint32_t solo;                            // última leitura do solo
+};
+
+static No_Estat_Type s_janela[SPENDIO_MAX];
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_taskTilt = NULL;
+
+#if TILT_ALARM_ENABLED
+
+#define TILT_BASE_LEITURAS  16              // leituras médias na base
+#define TILT_VQ             2               // vetores em ponto fixo Q2
+
+typedef enum {
+  TILT_BASE = 0,                            // acumulando a base
+  TILT_QUIETO,
+  TILT_ALARME,
+} t_eTiltEstado;
+
+// Detector de um nó: base e vetor atual (média móvel 1/4) em Q2, sem o zero do acelerômetro
+struct Detector_Type {
+  uint8_t estado;                           // t_eTiltEstado
+  uint8_t leituras;                         // leituras na base
+  uint8_t confirma;                         // leituras seguidas acima do limiar
+  int32_t base[TILT_EIXOS];                 // TILT_BASE: soma das leituras
+  int32_t atual[TILT_EIXOS];
+  uint16_t angulo;                          // última medida [mrad]
+  uint16_t anguloAlarme;                    // ângulo do último alarme [mrad]
+  uint32_t tempo;                           // da última medida [ms]
+};
+
+// Base mantida no deep sleep; o servidor pede outra pelo downlink 0x88
+RTC_DATA_ATTR static Detector_Type s_detector[SPENDIO_MAX];
+RTC_DATA_ATTR static bool s_novaBase;       // pedido de nova base, atendido pela task TILT
+static Alarme_Inclinacao_Type s_alarme;     // pendente de envio (mapa != 0)
+
+#endif
+
+//------------------------------------------------------------------------------
+//  acumula - Uma leitura no eixo (Welford)
+//
+static void acumula(Eixo_Estat_Type &e, uint16_t n, uint16_t x) {
+  int32_t xq = (int32_t)x << TILT_Q;
+  int32_t d = xq - e.media;
+
+  if (n == 1) {
+    e.media = xq;
+    e.m2 = 0;
+    e.min = e.max = x;
+    return;
+  }
+  e.media += (d >= 0) ? (d + n / 2) / n : -((-d + n / 2) / n);    // arredondado
+  e.m2 += (int64_t)d * (xq - e.media);
+  if (x < e.min) e.min = x;
+  if (x > e.max) e.max = x;
+}
+
+//------------------------------------------------------------------------------
+//  raizInteira - Raiz quadrada inteira (arredondada para baixo)
+//
+static uint32_t raizInteira(uint32_t v) {
+  uint32_t r = 0;
+  uint32_t b = 1UL << 30;
+
+  while (b > v) b >>= 2;
+  while (b) {
+    if (v >= r + b) {
+      v -= r + b;
+      r = (r >> 1) + b;
+    }
+    else r >>= 1;
+    b >>= 2;
+  }
+  return r;
+}
+
+#if TILT_ALARM_ENABLED
+
+//------------------------------------------------------------------------------
+//  anguloMrad - Ângulo entre dois vetores [mrad] (seno: pequenos ângulos)
+//
+//  sen² = |a x b|² / (|a|² |b|²), com as normas reduzidas até caber a razão
+//  em Q20; a raiz dá o seno em Q10.
+//
+static uint16_t anguloMrad(const int32_t *a, const int32_t *b) {
+  int64_t cx = (int64_t)a[1] * b[2] - (int64_t)a[2] * b[1];
+  int64_t cy = (int64_t)a[2] * b[0] - (int64_t)a[0] * b[2];
+  int64_t cz = (int64_t)a[0] * b[1] - (int64_t)a[1] * b[0];
+  uint64_t c2 = (uint64_t)(cx * cx) + (uint64_t)(cy * cy) + (uint64_t)(cz * cz);
+  uint64_t na = (uint64_t)((int64_t)a[0] * a[0] + (int64_t)a[1] * a[1] + (int64_t)a[2] * a[2]);
+  uint64_t nb = (uint64_t)((int64_t)b[0] * b[0] + (int64_t)b[1] * b[1] + (int64_t)b[2] * b[2]);
+
+  while (na >= (1ULL << 20)) { na >>= 1; c2 >>= 1; }
+  while (nb >= (1ULL << 20)) { nb >>= 1; c2 >>= 1; }
+  uint64_t n2 = na * nb;
+  if (n2 == 0) return 0;
+  if (c2 > n2) c2 = n2;
+
+  uint32_t seno = raizInteira((uint32_t)((c2 << 20) / n2));   // Q10
+  return (uint16_t)((seno * 1000 + 512) >> 10);
+}
+
+//------------------------------------------------------------------------------
+//  dispara - Registra o alarme do nó (enviado pelo laço principal)
+//
+static void dispara(uint8_t i, uint16_t angulo, uint16_t taxa) {
+  portENTER_CRITICAL(&s_mux);
+  s_alarme.mapa |= (1U << i);
+  s_alarme.angulo[i] = angulo;
+  s_alarme.taxa[i] = taxa;
+  portEXIT_CRITICAL(&s_mux);
+  LOGW("SENSOR", "Alarme de inclinação: sensor %c, %u mrad, %u mrad/s", SPENDIO_ENDERECOS[i],
+       (unsigned)angulo, (unsigned)taxa);
+}
+
+//------------------------------------------------------------------------------
+//  detecta - Uma leitura no detector do nó
+//
+//  Dispara depois de TILT_ALARM_CONFIRM leituras seguidas com o ângulo em
+//  relação à base >= TILT_ALARM_MRAD ou a taxa >= TILT_ALARM_RATE. Em
+//  alarme, dispara de novo a cada TILT_ALARM_MRAD a mais; volta ao
+//  repouso abaixo de TILT_ALARM_MRAD - TILT_ALARM_HYST com a taxa abaixo
+//  da metade do limiar.
+//
+static void detecta(uint8_t i, const SPendio_Amostra_Type &sp, uint32_t agora) {
+  Detector_Type &d = s_detector[i];
+  int32_t v[TILT_EIXOS] = { ((int32_t)sp.acx - TILT_ACC_ZERO) << TILT_VQ,
+                            ((int32_t)sp.acy - TILT_ACC_ZERO) << TILT_VQ,
+                            ((int32_t)sp.acz - TILT_ACC_ZERO) << TILT_VQ };
+
+  if (d.estado == TILT_BASE) {
+    if (d.leituras == 0) memset(d.base, 0, sizeof(d.base));
+    for (uint8_t e = 0; e < TILT_EIXOS; e++) d.base[e] += v[e];
+    if (++d.leituras < TILT_BASE_LEITURAS) return;
+    for (uint8_t e = 0; e < TILT_EIXOS; e++) {
+      d.base[e] /= TILT_BASE_LEITURAS;
+      d.atual[e] = d.base[e];
+    }
+    d.estado = TILT_QUIETO;
+    d.confirma = 0;
+    d.angulo = 0;
+    d.tempo = agora;
+    LOGI("SENSOR", "Sensor %c: base de inclinação definida", SPENDIO_ENDERECOS[i]);
+    return;
+  }
+
+  for (uint8_t e = 0; e < TILT_EIXOS; e++) d.atual[e] += (v[e] - d.atual[e]) / 4;
+
+  uint16_t angulo = anguloMrad(d.atual, d.base);
+  uint32_t dt = agora - d.tempo;
+  uint32_t taxa = ((angulo > d.angulo) && dt) ? (uint32_t)(angulo - d.angulo) * 1000 / dt : 0;
+  if (taxa > 0xFFFF) taxa = 0xFFFF;
+  d.angulo = angulo;
+  d.tempo = agora;
+
+  if (d.estado == TILT_QUIETO) {
+    bool acima = (angulo >= TILT_ALARM_MRAD) || (taxa >= TILT_ALARM_RATE);
+    d.confirma = acima ? d.confirma + 1 : 0;
+    if (d.confirma >= TILT_ALARM_CONFIRM) {
+      d.estado = TILT_ALARME;
+      d.anguloAlarme = angulo;
+      dispara(i, angulo, (uint16_t)taxa);
+    }
+  }
+  else if (angulo >= d.anguloAlarme + TILT_ALARM_MRAD) {             // o movimento continua
+    d.anguloAlarme = angulo;
+    dispara(i, angulo, (uint16_t)taxa);
+  }
+  else if ((angulo + TILT_ALARM_HYST < TILT_ALARM_MRAD) && (taxa * 2 < TILT_ALARM_RATE)) {
+    d.estado = TILT_QUIETO;
+    d.confirma = 0;
+  }
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+//  vTaskInclinacao - Varre os SPendio a cada TILT_SAMPLE_PERIOD_MS
+//
+static void vTaskInclinacao(void *pvParameters) {
+  static CPendio_Amostra_Type leitura;
+  TickType_t t = xTaskGetTickCount();
+
+  for (;;) {
+    varrSensoresSPendio(leitura);
+
+    portENTER_CRITICAL(&s_mux);
+    for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+      const SPendio_Amostra_Type &sp = leitura.spendio[i];
+      No_Estat_Type &no = s_janela[i];
+      if (!sp.valido || (no.n == 0xFFFF)) continue;
+      no.n++;
+      acumula(no.eixo[0], no.n, sp.acx);
+      acumula(no.eixo[1], no.n, sp.acy);
+      acumula(no.eixo[2], no.n, sp.acz);
+      no.solo = sp.solo;
+    }
+    portEXIT_CRITICAL(&s_mux);
+
+#if TILT_ALARM_ENABLED
+    portENTER_CRITICAL(&s_mux);
+    bool novaBase = s_novaBase;
+    s_novaBase = false;
+    portEXIT_CRITICAL(&s_mux);
+    if (novaBase) {
+      for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+        s_detector[i].estado = TILT_BASE;
+        s_detector[i].leituras = 0;
+      }
+    }
+
+    uint32_t agora = millis();
+    for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+      if (leitura.spendio[i].valido) detecta(i, leitura.spendio[i], agora);
+    }
+#endif
+
+    vTaskDelayUntil(&t, pdMS_TO_TICKS(TILT_SAMPLE_PERIOD_MS));
+  }
+}
+
+//------------------------------------------------------------------------------
+//  iniInclinacao - Cria a task de amostragem (depois da descoberta dos nós)
+//
+void iniInclinacao(void) {
+  if (s_taskTilt != NULL) return;
+  xTaskCreate(vTaskInclinacao, "TILT", configMINIMAL_STACK_SIZE + 2048, NULL, 1, &s_taskTilt);
+}
+
+//------------------------------------------------------------------------------
+//  inclinacaoJanela - Resumo da janela na amostra e início de outra janela
+//
+//  Nó sem leitura na janela fica ausente (valido = false). O desvio é o
+//  desvio padrão amostral (n - 1) em 1/4 de contagem.
+//
+void inclinacaoJanela(CPendio_Amostra_Type &amostra) {
+  static No_Estat_Type janela[SPENDIO_MAX];
+  uint16_t maior = 0;
+
+  portENTER_CRITICAL(&s_mux);
+  memcpy(janela, s_janela, sizeof(janela));
+  memset(s_janela, 0, sizeof(s_janela));
+  portEXIT_CRITICAL(&s_mux);
+
+  memset(amostra.spendio, 0, sizeof(amostra.spendio));
+  memset(amostra.estat, 0, sizeof(amostra.estat));
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+    const No_Estat_Type &no = janela[i];
+    if (no.n == 0) continue;
+    if (no.n > maior) maior = no.n;
+
+    SPendio_Amostra_Type &sp = amostra.spendio[i];
+    uint16_t media[TILT_EIXOS];
+    for (uint8_t e = 0; e < TILT_EIXOS; e++) {
+      media[e] = (uint16_t)((no.eixo[e].media + (1 << (TILT_Q - 1))) >> TILT_Q);
+      if (i >= NUM_SPENDIO) continue;
+      uint64_t var = (no.n > 1) ? (uint64_t)no.eixo[e].m2 / (no.n - 1) : 0;   // Q16
+      var >>= 2 * TILT_Q - 4;                                                  // Q4: raiz em Q2
+      amostra.estat[i].desvio[e] = (uint16_t)raizInteira((var > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)var);
+      amostra.estat[i].pp[e] = no.eixo[e].max - no.eixo[e].min;
+    }
+    sp.valido = true;
+    sp.acx = media[0];
+    sp.acy = media[1];
+    sp.acz = media[2];
+    sp.solo = no.solo;
+  }
+  amostra.janela = (maior > 0xFF) ? 0xFF : (uint8_t)maior;
+  LOGD("SENSOR", "Janela SPendio: %u leituras", (unsigned)maior);
+}
+
+//------------------------------------------------------------------------------
+//  inclinacaoAlarme - Alarme pendente de envio
+//
+bool inclinacaoAlarme(Alarme_Inclinacao_Type &alarme) {
+#if TILT_ALARM_ENABLED
+  portENTER_CRITICAL(&s_mux);
+  alarme = s_alarme;
+  portEXIT_CRITICAL(&s_mux);
+  return alarme.mapa != 0;
+#else
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  inclinacaoAlarmeEnviado - Retira os nós enviados (mapa) do alarme pendente
+//
+void inclinacaoAlarmeEnviado(uint16_t mapa) {
+#if TILT_ALARM_ENABLED
+  portENTER_CRITICAL(&s_mux);
+  s_alarme.mapa &= ~mapa;
+  portEXIT_CRITICAL(&s_mux);
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  inclinacaoNovaBase - Descarta as bases; as próximas leituras formam outras
+//
+//  Só o pedido: a task TILT, dona dos detectores, descarta as bases antes
+//  da próxima leitura.
+//
+void inclinacaoNovaBase(void) {
+#if TILT_ALARM_ENABLED
+  portENTER_CRITICAL(&s_mux);
+  s_novaBase = true;
+  portEXIT_CRITICAL(&s_mux);
+#endif
+}
+
+#else
+
+void iniInclinacao(void) {
+}
+
+bool inclinacaoAlarme(Alarme_Inclinacao_Type &alarme) {
+  return false;
+}
+
+void inclinacaoAlarmeEnviado(uint16_t mapa) {
+}
+
+void inclinacaoNovaBase(void) {
+}
+
+void inclinacaoJanela(CPendio_Amostra_Type &amostra) {
+  varrSensoresSPendio(amostra);             // leitura única
+  memset(amostra.estat, 0, sizeof(amostra.estat));
+  amostra.janela = 0;
+}
+
+#endif
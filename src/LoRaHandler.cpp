@@ -11,6 +11,10 @@
 // Constantes internas
 static const unsigned long DEFAULT_JOIN_TIMEOUT = 30000;      // 30s
 static const unsigned long DEFAULT_CFM_TIMEOUT = 6000;        // 6s
+static const unsigned long DEFAULT_LINK_POLL = 60000;         // 60s
+static const unsigned long UNJOINED_LINK_POLL = 1000;         // 1s (aguardando JOIN)
+static const unsigned long DEFAULT_CFM_POLL = 2000;           // 2s (consultas da confirmação)
+static const unsigned long RX2_END_DELAY = 3000;              // RECEIVE_DELAY2 (2s) + janela RX2, após o fim do TX
 
 /**
  * @brief Construtor
@@ -21,7 +25,17 @@ LoRaHandler::LoRaHandler(const LoRaConfig& cfg)
       currentState(ConnectionState::DISCONNECTED),
       confirmed(false),
       lastSendTime(0),
-      retryCount(0) {
+      rxEndTime(0),
+      lastCfmPoll(0),
+      retryCount(0),
+      linkJoined(false),
+      linkKnown(false),
+      lastLinkPoll(0),
+      joinStartTime(0),
+      dataRate((!cfg.useADR && cfg.fixedDR <= 6) ? cfg.fixedDR : 0),
+      dataRateKnown(!cfg.useADR && cfg.fixedDR <= 6),
+      connectCallback(nullptr),
+      confirmCallback(nullptr) {
     
     if (!cfg.serial) {
         config.serial = &Serial1;  // Default serial if not provided
@@ -128,6 +142,23 @@ bool LoRaHandler::begin() {
 
     currentState = ConnectionState::DISCONNECTED;
     LOGI("LoRa", "Handler inicializado com sucesso");
+    logLatencyStats();
+    return true;
+}
+
+/**
+ * @brief Retoma o handler após o deep sleep
+ */
+bool LoRaHandler::resume() {
+    // O módulo não é reiniciado: a configuração e a sessão (JOIN) continuam válidas
+    if (lorawan.ping() != CommandResponse::OK) {
+        LOGW("LoRa", "Módulo não respondeu ao retomar");
+        return false;
+    }
+
+    linkKnown = false;                              // força a consulta do link
+    currentState = linkStatus(0) ? ConnectionState::CONNECTED : ConnectionState::DISCONNECTED;
+    LOGI("LoRa", "Handler retomado (%s)", getStateString());
     return true;
 }
 
@@ -140,45 +171,84 @@ void LoRaHandler::end() {
 }
 
 /**
- * @brief Conecta à rede (OTAA Join)
+ * @brief Inicia a conexão à rede (OTAA Join)
  */
 bool LoRaHandler::connect() {
     if (currentState == ConnectionState::CONNECTED) {
         return true;
     }
 
+    if (currentState == ConnectionState::CONNECTING) {
+        return false;                       // JOIN já em andamento
+    }
+
     LOGI("LoRa", "Tentando conectar à rede (JOIN)...");
-    currentState = ConnectionState::CONNECTING;
+
+    linkJoined = false;
+    linkKnown = false;
 
     CommandResponse response = lorawan.join();
     if (response != CommandResponse::OK) {
         LOGE("LoRa", "Falha ao enviar JOIN");
         currentState = ConnectionState::ERROR;
+        if (connectCallback) connectCallback(false);
         return false;
     }
 
-    // Aguarda join com timeout
-    unsigned long startTime = millis();
-    while ((millis() - startTime) < (config.joinTimeout ? config.joinTimeout : DEFAULT_JOIN_TIMEOUT)) {
-        delay(100);
-        if (lorawan.isConnected()) {
-            LOGI("LoRa", "Conectado com sucesso");
-            currentState = ConnectionState::CONNECTED;
-            return true;
-        }
-    }
-    LOGE("LoRa", "TIMEOUT: Falha ao conectar");
-    currentState = ConnectionState::ERROR;
+    // O resultado é acompanhado em process()
+    currentState = ConnectionState::CONNECTING;
+    joinStartTime = millis();
     return false;
 }
 
+/**
+ * @brief Define o callback de conclusão do JOIN
+ */
+void LoRaHandler::setConnectCallback(ConnectCallback callback) {
+    connectCallback = callback;
+}
+
+/**
+ * @brief Define o callback da confirmação
+ */
+void LoRaHandler::setConfirmCallback(ConfirmCallback callback) {
+    confirmCallback = callback;
+}
+
+/**
+ * @brief Fim das janelas RX do último envio
+ */
+bool LoRaHandler::rxWindowsDone() {
+    return (long)(millis() - rxEndTime) >= 0;
+}
+
+/**
+ * @brief Conclui o JOIN em andamento
+ */
+void LoRaHandler::finishConnect(bool connected) {
+    if (connected) {
+        LOGI("LoRa", "Conectado com sucesso (%lu ms)", (unsigned long)(millis() - joinStartTime));
+        currentState = ConnectionState::CONNECTED;
+        if (config.useADR) dataRateKnown = false;   // nova sessão: DR do JOIN
+    } else {
+        LOGE("LoRa", "TIMEOUT: Falha ao conectar");
+        currentState = ConnectionState::ERROR;
+    }
+
+    if (connectCallback) connectCallback(connected);
+}
+
 /**
  * @brief Verifica se está conectado
  */
 bool LoRaHandler::isConnected() {
-    bool connected = lorawan.isConnected();
+    unsigned long maxAge = config.linkPollInterval ? config.linkPollInterval : DEFAULT_LINK_POLL;
+    // Enquanto não conectado, o cache expira rápido para detectar o JOIN
+    bool connected = linkStatus(linkJoined ? maxAge : UNJOINED_LINK_POLL);
     
-    if (connected && currentState != ConnectionState::CONNECTED && 
+    if (connected && currentState == ConnectionState::CONNECTING) {
+        finishConnect(true);
+    } else if (connected && currentState != ConnectionState::CONNECTED && 
         currentState != ConnectionState::WAITING_CONFIRMATION) {
         currentState = ConnectionState::CONNECTED;
     }
@@ -203,11 +273,27 @@ SendResult LoRaHandler::send(uint8_t port, const uint8_t* data, uint16_t length)
     // Enviar mensagem
     LOGD("LoRa", "Enviando %u bytes...", (unsigned)length);
 
+    confirmed = false;
+    readDataRate();                         // DR deste uplink (getAirtime não consulta o módulo durante o TX)
     CommandResponse response = lorawan.sendX(port, (const char*)data);
 
+    if (response == CommandResponse::NO_NETWORK) {
+        // O módulo perdeu a sessão: invalida o cache
+        linkJoined = false;
+        lastLinkPoll = millis();
+        currentState = ConnectionState::DISCONNECTED;
+        LOGE("LoRa", "Envio recusado: rede não conectada");
+        return SendResult::NOT_CONNECTED;
+    }
+
     if (response == CommandResponse::OK) {
         lastSendTime = millis();
+        rxEndTime = lastSendTime + getAirtime(length / 2) + RX2_END_DELAY;   // AT+SENDX: 2 caracteres hexa por byte
+        lastCfmPoll = rxEndTime - (config.cfmPollInterval ? config.cfmPollInterval : DEFAULT_CFM_POLL);   // 1ª consulta no fim da RX2
         retryCount = 0;
+        if (config.useADR) dataRateKnown = false;   // LinkADRReq nas janelas RX
+        linkJoined = true;                  // Uplink aceito confirma o JOIN
+        lastLinkPoll = lastSendTime;
         if (config.useConfirmation) currentState = ConnectionState::WAITING_CONFIRMATION;
         else currentState = ConnectionState::CONNECTED;
         LOGI("LoRa", "Envio aceito (port=%u, len=%u)", (unsigned)port, (unsigned)length);
@@ -227,7 +313,7 @@ bool LoRaHandler::isConfirmed() {
         return (currentState != ConnectionState::WAITING_CONFIRMATION);
     }
 
-    bool result = lorawan.isConfirmed();
+    bool result = confirmed || lorawan.isConfirmed();
     
     if (result && currentState == ConnectionState::WAITING_CONFIRMATION) {
         confirmed = true;
@@ -257,11 +343,7 @@ ReceiveResult LoRaHandler::receive(DownlinkMessage& message) {
     // Armazenar mensagem
     message.port = port;
     message.timestamp = millis();
-    message.length = 0;
-
-    while (buffer.available() && message.length < sizeof(message.data)) {
-        message.data[message.length++] = buffer.read();
-    }
+    message.length = buffer.view().copy(message.data, buffer.available());
 
     // Guardar referência
     lastDownlink = message;
@@ -283,10 +365,36 @@ ConnectionState LoRaHandler::getConnectionState() {
  * @brief Processa eventos
  */
 void LoRaHandler::process() {
-    // Verifica timeouts
+    // Avança o JOIN em andamento
+    if (currentState == ConnectionState::CONNECTING) {
+        unsigned long timeout = config.joinTimeout ? config.joinTimeout : DEFAULT_JOIN_TIMEOUT;
+
+        if (linkStatus(UNJOINED_LINK_POLL)) {
+            finishConnect(true);
+        } else if ((millis() - joinStartTime) >= timeout) {
+            finishConnect(false);
+        }
+        return;
+    }
+
+    // Confirmação: consulta AT+CFS=? a partir do fim da RX2; timeout se não chegar
     if (currentState == ConnectionState::WAITING_CONFIRMATION) {
-        unsigned long elapsed = millis() - lastSendTime;
+        unsigned long now = millis();
+        unsigned long elapsed = now - lastSendTime;
         unsigned long timeout = config.confirmTimeout ? config.confirmTimeout : DEFAULT_CFM_TIMEOUT;
+        unsigned long poll = config.cfmPollInterval ? config.cfmPollInterval : DEFAULT_CFM_POLL;
+
+        if (rxWindowsDone() && (now - lastCfmPoll) >= poll) {
+            lastCfmPoll = now;
+            if (lorawan.isConfirmed()) {
+                LOGI("LoRa", "Confirmado (%lu ms)", (unsigned long)elapsed);
+                confirmed = true;
+                retryCount = 0;
+                currentState = ConnectionState::CONNECTED;
+                if (confirmCallback) confirmCallback(true);
+                return;
+            }
+        }
 
         if (elapsed > timeout) {
             if (retryCount++ < config.maxRetries) {
@@ -297,6 +405,7 @@ void LoRaHandler::process() {
                 currentState = ConnectionState::ERROR;
                 retryCount = 0;
             }
+            if (confirmCallback) confirmCallback(false);
         }
     }
 
@@ -309,17 +418,47 @@ void LoRaHandler::process() {
  */
 void LoRaHandler::updateState() {
     if (currentState == ConnectionState::ERROR || 
-        currentState == ConnectionState::DISCONNECTED) {
+        currentState == ConnectionState::DISCONNECTED ||
+        currentState == ConnectionState::CONNECTING) {
         return;
     }
 
     if (currentState != ConnectionState::WAITING_CONFIRMATION) {
-        if (!lorawan.isConnected()) {
+        if (!isConnected()) {
             currentState = ConnectionState::DISCONNECTED;
         }
     }
 }
 
+/**
+ * @brief Processa notificações assíncronas do módulo
+ */
+void LoRaHandler::handleEvents() {
+    uint8_t events = lorawan.listen();
+
+    // Só uma dica: o formato das notificações não é documentado, então o
+    // estado vem sempre da consulta (AT+NJS), feita já na próxima verificação
+    if (events & SMW_SX1262M0_EVENT_JOINED) {
+        LOGD("LoRa", "Evento: JOINED (consultando o módulo)");
+        linkKnown = false;
+    }
+}
+
+/**
+ * @brief Obtém o estado do link (cache + consulta periódica)
+ */
+bool LoRaHandler::linkStatus(unsigned long maxAge) {
+    handleEvents();
+
+    if (!linkKnown || (millis() - lastLinkPoll) >= maxAge) {
+        linkJoined = lorawan.isConnected();
+        linkKnown = true;
+        lastLinkPoll = millis();
+    }
+
+    return linkJoined;
+}
+
 /**
  * @brief Traduz CommandResponse para SendResult
  */
@@ -372,6 +511,7 @@ bool LoRaHandler::setConfirmation(bool enabled) {
  */
 bool LoRaHandler::setADR(bool enabled) {
     config.useADR = enabled;
+    dataRateKnown = false;
     CommandResponse response = lorawan.set_ADR(enabled ? 
                                                SMW_SX1262M0_ADR_ON : 
                                                SMW_SX1262M0_ADR_OFF);
@@ -388,15 +528,79 @@ bool LoRaHandler::setADR(bool enabled) {
  */
 bool LoRaHandler::setDataRate(uint8_t dr) {
     config.fixedDR = dr;
+    dataRateKnown = false;
     CommandResponse response = lorawan.set_DR(dr);
     
     if (response == CommandResponse::OK) {
+        dataRate = dr;
+        dataRateKnown = (dr <= 6);
         lorawan.save();
         return true;
     }
     return false;
 }
 
+/**
+ * @brief Payload máximo no DR atual
+ */
+uint8_t LoRaHandler::getMaxPayload() {
+    // AU915 (RP002-1.0.x), UplinkDwellTime = 0: DR0..DR6
+    static const uint8_t MAX_PAYLOAD[] = { 51, 51, 51, 115, 242, 242, 242 };
+
+    return MAX_PAYLOAD[readDataRate()];
+}
+
+/**
+ * @brief Tempo no ar no DR atual
+ */
+uint32_t LoRaHandler::getAirtime(uint8_t length) {
+    // AU915: DR0..DR5 = SF12..SF7 em 125 kHz, DR6 = SF8 em 500 kHz
+    uint8_t dr = dataRate;                  // lido em send(): sem AT+DR=? com o rádio em TX
+    int32_t sf = (dr < 6) ? 12 - dr : 8;
+    int32_t de = ((dr < 6) && (sf >= 11)) ? 1 : 0;               // low data rate optimize
+    uint32_t tSimbolo = (1UL << sf) * 1000UL / ((dr < 6) ? 125 : 500);   // [us]
+
+    int32_t pl = (int32_t)length + 13;
+    int32_t num = 8 * pl - 4 * sf + 28 + 16;                      // CRC ligado, cabeçalho explícito
+    int32_t den = 4 * (sf - 2 * de);
+    uint32_t simbolos = 8 + ((num > 0) ? (uint32_t)((num + den - 1) / den) * 5 : 0);   // CR 4/5
+
+    uint32_t us = tSimbolo * 49 / 4 + simbolos * tSimbolo;       // preâmbulo: 8 + 4,25 símbolos
+    return (us + 999) / 1000;
+}
+
+/**
+ * @brief Data rate atual
+ */
+uint8_t LoRaHandler::readDataRate() {
+    uint8_t dr = 0;
+
+    if (!dataRateKnown) {
+        if (lorawan.get_DR(dr) == CommandResponse::OK && dr <= 6) {
+            dataRate = dr;
+            dataRateKnown = true;
+        } else {
+            LOGW("LoRa", "Falha ao ler DR, mantendo DR%u", (unsigned)dataRate);
+        }
+    }
+    return dataRate;
+}
+
+/**
+ * @brief Registra latência dos comandos AT
+ */
+void LoRaHandler::logLatencyStats() {
+#ifdef SMW_SX1262M0_STATISTICS
+    SMW_SX1262M0_Statistics stats;
+    for (uint8_t i = 0; lorawan.get_statistics_at(i, stats); i++) {
+        LOGD("LoRa", "AT+%s: n=%u timeout=%u last=%lums max=%lums avg=%lums",
+             stats.command, (unsigned)stats.count, (unsigned)stats.timeouts,
+             (unsigned long)stats.last, (unsigned long)stats.max,
+             (unsigned long)(stats.count ? (stats.total / stats.count) : 0));
+    }
+#endif
+}
+
 /**
  * @brief Obtém descrição do estado
  */
@@ -0,0 +1,277 @@
+/**
+ * @file Payload.cpp
+ * @brief Implementação da formatação dos frames de uplink (v01 a v06 e alarme)
+ * @copyright Copyright (c) 2025
+ */
+
+#include "Aplic.h"
+#include "config.h"
+#include "Payload.h"
+#include "Historico.h"
+
+using PayloadSchema::EsquemaV01;
+using PayloadSchema::EsquemaV02;
+using PayloadSchema::EsquemaV06;
+
+// O layout do frame v01 (Sensores.h) tem que coincidir com o esquema
+static_assert(sizeof(SPendio_Data_Type) * 4 == PayloadSchema::SPendioV01<0>::bits,
+              "SPendio_Data_Type não confere com o esquema v01");
+static_assert(sizeof(CPendio_Sensor_Data_Type) == EsquemaV01::bits / 4 + 1,
+              "CPendio_Sensor_Data_Type não confere com o esquema v01 (+ finalizador)");
+static_assert(EsquemaV02::bytes <= LORA_MAX_PAYLOAD, "frame v02 maior que LORA_MAX_PAYLOAD");
+static_assert(BATCH_MAX_SAMPLES >= 1 && BATCH_MAX_SAMPLES <= PayloadSchema::LOTE_MAX,
+              "BATCH_MAX_SAMPLES fora da faixa do lote v03");
+
+static_assert((PayloadSchema::LOTE_BITS_VERSAO + PayloadSchema::LOTE_BITS_QUANT + PayloadSchema::LOTE_BITS_IDADE
+               + PayloadSchema::DELTA_BITS_TIPO + PayloadSchema::AmostraV02::bits + 7) / 8 <= 51,
+              "keyframe v04 não cabe no DR0 do AU915 (51 bytes)");
+static_assert(DELTA_KEYFRAME_INTERVAL >= 1, "DELTA_KEYFRAME_INTERVAL inválido");
+static_assert(DELTA_MAX_AGE <= 0xFFFF, "DELTA_MAX_AGE maior que o campo de idade do lote");
+static_assert(PayloadSchema::bytesV05(1) <= 51, "frame v05 com um nó não cabe no DR0 do AU915 (51 bytes)");
+static_assert(EsquemaV06::bytes <= 51, "frame v06 não cabe no DR0 do AU915 (51 bytes)");
+static_assert(PayloadSchema::bytesAlarme(SPENDIO_MAX) <= 51, "alarme com todos os nós não cabe no DR0 do AU915 (51 bytes)");
+
+static const char TabHexa[] = "0123456789ABCDEF";
+
+// Referência do delta: última amostra do último frame v04 aceito (memória RTC)
+RTC_DATA_ATTR static CPendio_Amostra_Type s_referencia;
+RTC_DATA_ATTR static bool s_refValida;
+RTC_DATA_ATTR static uint8_t s_framesDesdeKey;
+
+// Primeira posição do próximo frame v05 (rodízio quando os nós não cabem)
+RTC_DATA_ATTR static uint8_t s_proximoNo;
+
+// Frame v04 montado, aguardando o resultado do envio
+static CPendio_Amostra_Type s_pendente;
+static bool s_pendenteKey;
+
+/**
+ * @brief Monta o frame v01
+ */
+void montaPayloadV01(const CPendio_Amostra_Type &amostra, CPendio_Sensor_Data_Type &dado) {
+  uint8_t frame[EsquemaV01::bytes] = { 0 };
+
+  EsquemaV01::codifica(amostra, frame);
+  payloadHex(frame, sizeof(frame), (char *)&dado);   // inclui o finalizador
+}
+
+/**
+ * @brief Monta o frame v02
+ */
+uint8_t montaPayloadV02(const CPendio_Amostra_Type &amostra, uint8_t *frame) {
+  memset(frame, 0, EsquemaV02::bytes);
+  EsquemaV02::codifica(amostra, frame);
+  return EsquemaV02::bytes;
+}
+
+/**
+ * @brief Amostras por frame
+ */
+uint8_t amostrasPorFrame(uint16_t maxBytes) {
+  uint8_t n = 1;
+  while ((n < PayloadSchema::LOTE_MAX) && (PayloadSchema::bytesLote(n + 1) <= maxBytes)) n++;
+  return n;
+}
+
+/**
+ * @brief Monta o frame do lote
+ */
+uint8_t montaPayloadLote(uint8_t n, uint32_t agora, uint8_t *frame) {
+  using namespace PayloadSchema;
+
+  if (n <= 1) return montaPayloadV02(historicoLe(0).amostra, frame);
+
+  uint16_t tam = bytesLote(n);
+  uint16_t pos = 0;
+
+  memset(frame, 0, tam);
+  putBits(frame, pos, PAYLOAD_V03, LOTE_BITS_VERSAO);
+  pos += LOTE_BITS_VERSAO;
+  putBits(frame, pos, n, LOTE_BITS_QUANT);
+  pos += LOTE_BITS_QUANT;
+
+  for (uint8_t i = 0; i < n; i++) {
+    const Registro_Amostra_Type &r = historicoLe(i);
+    uint32_t idade = agora - r.tempo;
+    if (idade > 0xFFFF) idade = 0xFFFF;
+    putBits(frame, pos, idade, LOTE_BITS_IDADE);
+    pos += LOTE_BITS_IDADE;
+    AmostraV02::codifica(r.amostra, frame, pos);
+    pos += AmostraV02::bits;
+  }
+  return (uint8_t)tam;
+}
+
+/**
+ * @brief Monta o frame v04
+ */
+uint8_t montaPayloadDelta(uint16_t maxBytes, uint32_t agora, uint8_t *frame, uint8_t &n) {
+  using namespace PayloadSchema;
+
+  if (maxBytes > LORA_MAX_PAYLOAD) maxBytes = LORA_MAX_PAYLOAD;
+  uint16_t maxBits = maxBytes * 8;
+  uint16_t pos = LOTE_BITS_VERSAO + LOTE_BITS_QUANT;
+  uint8_t quant = historicoQuant();
+
+  // Delta entre frames só com referência aceita e dentro do intervalo de keyframe.
+  // A referência é o valor que o servidor reconstrói (o keyframe satura na largura v02).
+  CPendio_Amostra_Type ref = s_referencia;
+  bool temRef = s_refValida && (s_framesDesdeKey < DELTA_KEYFRAME_INTERVAL);
+
+  memset(frame, 0, maxBytes);
+  n = 0;
+  while ((n < quant) && (n < LOTE_MAX)) {
+    const Registro_Amostra_Type &r = historicoLe(n);
+    bool key = !temRef || !mesmaPresenca(r.amostra, ref) || !AmostraDelta::cabe(r.amostra, ref);
+    uint16_t bits = LOTE_BITS_IDADE + DELTA_BITS_TIPO
+                  + (key ? AmostraV02::bits : AmostraDelta::campos + AmostraDelta::bits(r.amostra, ref));
+    if (pos + bits > maxBits) break;
+
+    uint32_t idade = agora - r.tempo;
+    if (idade > 0xFFFF) idade = 0xFFFF;
+    putBits(frame, pos, idade, LOTE_BITS_IDADE);
+    pos += LOTE_BITS_IDADE;
+    putBits(frame, pos, key ? 1 : 0, DELTA_BITS_TIPO);
+    pos += DELTA_BITS_TIPO;
+
+    if (key) {
+      AmostraV02::codifica(r.amostra, frame, pos);
+      ref = CPendio_Amostra_Type();
+      AmostraV02::decodifica(frame, pos, ref);              // valor visto pelo servidor
+      pos += AmostraV02::bits;
+    }
+    else {
+      uint16_t dados = pos + AmostraDelta::campos;
+      AmostraDelta::codifica(r.amostra, ref, frame, pos, dados);
+      ref = r.amostra;                                      // delta reconstrói o valor exato
+      pos = dados;
+    }
+
+    if (n == 0) s_pendenteKey = key;
+    temRef = true;                                          // próxima amostra: delta desta
+    n++;
+  }
+
+  // Todas couberam e ainda há espaço na fila: espera a próxima amostra,
+  // a não ser que a mais antiga já tenha DELTA_MAX_AGE
+  bool espera = (n == quant) && (quant < historicoCapacidade())
+             && ((uint32_t)(agora - historicoLe(0).tempo) < DELTA_MAX_AGE);
+  if ((n == 0) || espera) {
+    n = 0;
+    return 0;
+  }
+
+  putBits(frame, 0, PAYLOAD_V04, LOTE_BITS_VERSAO);
+  putBits(frame, LOTE_BITS_VERSAO, n, LOTE_BITS_QUANT);
+  s_pendente = ref;
+  return (uint8_t)((pos + 7) / 8);
+}
+
+/**
+ * @brief Frame v04 aceito
+ */
+void payloadDeltaAceito(uint8_t n) {
+  historicoDescarta(n);
+  s_referencia = s_pendente;
+  s_refValida = true;
+  s_framesDesdeKey = s_pendenteKey ? 1 : s_framesDesdeKey + 1;
+}
+
+/**
+ * @brief Frame v04 possivelmente perdido
+ */
+void payloadDeltaPerdido(void) {
+  s_refValida = false;
+}
+
+/**
+ * @brief Monta o frame v05
+ */
+uint8_t montaPayloadV05(const CPendio_Amostra_Type &amostra, uint16_t registro, uint16_t maxBytes, uint8_t *frame) {
+  using namespace PayloadSchema;
+
+  if (maxBytes > LORA_MAX_PAYLOAD) maxBytes = LORA_MAX_PAYLOAD;
+  if (s_proximoNo >= SPENDIO_MAX) s_proximoNo = 0;
+
+  // Nós no frame: a partir de s_proximoNo, até encher o payload
+  uint16_t mapa = 0;
+  uint8_t n = 0;
+  uint8_t no = s_proximoNo;
+  for (uint8_t k = 0; k < SPENDIO_MAX; k++, no = (no + 1) % SPENDIO_MAX) {
+    if (!(registro & (1U << no))) continue;
+    if (bytesV05(n + 1) > maxBytes) break;
+    mapa |= (1U << no);
+    n++;
+  }
+  s_proximoNo = no;
+
+  uint16_t tam = bytesV05(n);
+  uint16_t pos = 0;
+
+  memset(frame, 0, tam);
+  putBits(frame, pos, PAYLOAD_V05, LOTE_BITS_VERSAO);
+  pos += LOTE_BITS_VERSAO;
+  putBits(frame, pos, mapa, V05_BITS_MAPA);
+  pos += V05_BITS_MAPA;
+  AmbienteV02::codifica(amostra, frame, pos);
+  pos += AmbienteV02::bits;
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+    if (!(mapa & (1U << i))) continue;
+    NosV05<>::codifica(i, amostra, frame, pos);
+    pos += NoV05<0>::bits;
+  }
+  return (uint8_t)tam;
+}
+
+/**
+ * @brief Monta o frame v06
+ */
+uint8_t montaPayloadV06(const CPendio_Amostra_Type &amostra, uint8_t *frame) {
+  memset(frame, 0, EsquemaV06::bytes);
+  EsquemaV06::codifica(amostra, frame);
+  return EsquemaV06::bytes;
+}
+
+/**
+ * @brief Monta o frame de alarme de inclinação
+ */
+uint8_t montaPayloadAlarme(const Alarme_Inclinacao_Type &alarme, uint8_t *frame) {
+  using namespace PayloadSchema;
+
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+    if (alarme.mapa & (1U << i)) n++;
+  }
+
+  uint16_t tam = bytesAlarme(n);
+  uint16_t pos = 0;
+
+  memset(frame, 0, tam);
+  putBits(frame, pos, PAYLOAD_ALARME, LOTE_BITS_VERSAO);
+  pos += LOTE_BITS_VERSAO;
+  putBits(frame, pos, alarme.mapa, V05_BITS_MAPA);
+  pos += V05_BITS_MAPA;
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) {
+    if (!(alarme.mapa & (1U << i))) continue;
+    uint16_t angulo = alarme.angulo[i];
+    uint16_t taxa = alarme.taxa[i];
+    if (angulo >> ALARME_BITS_ANGULO) angulo = (1U << ALARME_BITS_ANGULO) - 1;
+    if (taxa >> ALARME_BITS_TAXA) taxa = (1U << ALARME_BITS_TAXA) - 1;
+    putBits(frame, pos, angulo, ALARME_BITS_ANGULO);
+    pos += ALARME_BITS_ANGULO;
+    putBits(frame, pos, taxa, ALARME_BITS_TAXA);
+    pos += ALARME_BITS_TAXA;
+  }
+  return (uint8_t)tam;
+}
+
+/**
+ * @brief Converte frame binário em ASCII hexa
+ */
+void payloadHex(const uint8_t *frame, uint8_t tam, char *hex) {
+  for (uint8_t i = 0; i < tam; i++) {
+    *hex++ = TabHexa[frame[i] >> 4];
+    *hex++ = TabHexa[frame[i] & 0x0f];
+  }
+  *hex = 0;
+}
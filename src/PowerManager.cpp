@@ -0,0 +1,79 @@
+/**
+ * @file PowerManager.cpp
+ * @brief Implementação do gerenciamento de energia (deep sleep)
+ * @copyright Copyright (c) 2025
+ */
+
+#include "PowerManager.h"
+#include <esp_sleep.h>
+#include <sys/time.h>
+#include "config.h"
+#include "Logger.h"
+
+bool PowerManager::_warmBoot = false;
+bool PowerManager::_gpioWake = false;
+RTC_DATA_ATTR uint32_t PowerManager::_sleepUntil = 0;
+
+/**
+ * @brief Identifica a causa do boot
+ */
+void PowerManager::begin() {
+  // Somente a volta do deep sleep preserva a memória RTC;
+  // reset e power-on reinicializam as variáveis RTC_DATA_ATTR.
+  esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+  _warmBoot = (cause != ESP_SLEEP_WAKEUP_UNDEFINED);
+  _gpioWake = (cause == ESP_SLEEP_WAKEUP_EXT0) || (cause == ESP_SLEEP_WAKEUP_ULP);   // pluviômetro (EXT0 ou ULP)
+}
+
+/**
+ * @brief Indica volta do deep sleep
+ */
+bool PowerManager::isWarmBoot() {
+  return _warmBoot;
+}
+
+/**
+ * @brief Indica despertar por GPIO
+ */
+bool PowerManager::isGpioWake() {
+  return _gpioWake;
+}
+
+/**
+ * @brief Tempo restante do último deep sleep
+ */
+uint32_t PowerManager::remainingSleep() {
+  int32_t remaining = (int32_t)(_sleepUntil - rtcMillis());   // seguro na passagem por zero
+  return (remaining > 0) ? (uint32_t)remaining : 0;
+}
+
+/**
+ * @brief Relógio RTC em ms
+ */
+uint32_t PowerManager::rtcMillis() {
+  // O relógio do sistema é mantido pelo timer RTC durante o deep sleep
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint32_t)((uint64_t)tv.tv_sec * 1000ULL + (uint64_t)(tv.tv_usec / 1000));
+}
+
+/**
+ * @brief Relógio RTC em s
+ */
+uint32_t PowerManager::rtcSegundos() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (uint32_t)tv.tv_sec;
+}
+
+/**
+ * @brief Entra em deep sleep
+ */
+void PowerManager::deepSleep(uint32_t ms) {
+  LOGI("POWER", "Deep sleep por %lu ms", (unsigned long)ms);
+  Serial.flush();
+
+  _sleepUntil = rtcMillis() + ms;
+  esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+  esp_deep_sleep_start();
+}
@@ -0,0 +1,185 @@
+/*
+  --------------------------------------------------------------------------------
+                                                              Início: 17/10/2026
+        Proj.:  WCPendio - Sistema de monitoramento de Taludes e Encostas
+        Fonte:  RS485.cpp
+        Progs:  Eng. Prof. Nuncio Perrella, MSc e Arnaldo
+        Descr.: Barramento RS485 (SPendio) - transações por evento
+                (onReceive da UART), fila de pedidos e de conclusões
+                                                              Última: 17/10/2026
+  --------------------------------------------------------------------------------
+        Diario de Bordo
+        ---------------
+  17/10/2026 - Transações por evento (antes: varredura de Serial2 a cada 10 ms)
+  17/10/2026 - Modo binário (frame com tamanho e CRC-16/Modbus)
+
+*/
+
+#include "Aplic.h"
+#include "RS485.h"
+#include <freertos/queue.h>
+
+struct RS485_Pedido_Type {
+  char endereco;
+  bool binario;
+  uint16_t prazo;                           // [ms]
+};
+
+static QueueHandle_t s_pedidos = NULL;
+static QueueHandle_t s_conclusoes = NULL;
+static TaskHandle_t s_taskRS485 = NULL;
+
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool s_ativo;                        // transação aguardando resposta
+static RS485_Transacao_Type s_atual;        // preenchida pelo onReceive
+
+//------------------------------------------------------------------------------
+//  rs485_TX - Habilita Transmissão RS485
+//
+static void rs485_TX(void) {
+  digitalWrite(nRE, HIGH);
+  digitalWrite(pDE, HIGH);
+}
+
+//------------------------------------------------------------------------------
+//  rs485_RX - Habilita Recepção RS485
+//
+static void rs485_RX(void) {
+  digitalWrite(pDE, LOW);
+  digitalWrite(nRE, LOW);
+}
+
+//------------------------------------------------------------------------------
+//  rs485Recebe - onReceive da Serial2 (task de eventos da UART)
+//
+//  Acumula a resposta da transação ativa e acorda a task RS485 no LF (ASCII)
+//  ou ao completar o tamanho do frame (binário). Caracteres fora de
+//  transação (resposta atrasada) são descartados.
+//
+static void rs485Recebe(void) {
+  bool fim = false;
+
+  while (!fim && (Serial2.available() > 0)) {
+    int c = Serial2.read();
+
+    portENTER_CRITICAL(&s_mux);
+    if (s_ativo) {
+      if (!s_atual.binario && (c == LF)) {
+        s_atual.status = RS485_OK;
+        fim = true;
+      }
+      else if (s_atual.tam >= RS485_TAM_RESPOSTA - 1) {
+        s_atual.status = RS485_ESTOURO;
+        fim = true;
+      }
+      else {
+        s_atual.resposta[s_atual.tam++] = (char)c;
+        if (s_atual.binario && (s_atual.tam == (uint8_t)s_atual.resposta[0] + 3)) {   // LEN + dados + CRC
+          s_atual.status = RS485_OK;
+          fim = true;
+        }
+      }
+      if (fim) s_ativo = false;
+    }
+    portEXIT_CRITICAL(&s_mux);
+  }
+  if (fim) xTaskNotifyGive(s_taskRS485);
+}
+
+//------------------------------------------------------------------------------
+//  vTaskRS485 - Executa os pedidos em sequência
+//
+//  O próximo pedido é enviado assim que a resposta anterior termina; a task
+//  fica bloqueada (sem varredura) enquanto espera a resposta ou o prazo.
+//
+static void vTaskRS485(void *pvParameters) {
+  RS485_Pedido_Type p;
+  RS485_Transacao_Type t;
+
+  for (;;) {
+    xQueueReceive(s_pedidos, &p, portMAX_DELAY);
+
+    while (Serial2.available() > 0) Serial2.read();   // sobra de resposta atrasada
+    ulTaskNotifyTake(pdTRUE, 0);                      // descarta notificação atrasada
+
+    portENTER_CRITICAL(&s_mux);
+    memset(&s_atual, 0, sizeof(s_atual));
+    s_atual.endereco = p.endereco;
+    s_atual.binario = p.binario;
+    s_atual.status = RS485_TIMEOUT;
+    s_ativo = true;
+    portEXIT_CRITICAL(&s_mux);
+
+    uint32_t inicio = millis();
+    rs485_TX();
+    Serial2.write(p.binario ? (uint8_t)(p.endereco | RS485_PEDIDO_BIN) : (uint8_t)p.endereco);
+    Serial2.flush();                                  // espera o último bit sair
+    rs485_RX();                                       // libera o barramento para a resposta
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(p.prazo));
+
+    portENTER_CRITICAL(&s_mux);
+    s_ativo = false;
+    t = s_atual;
+    portEXIT_CRITICAL(&s_mux);
+
+    t.resposta[t.tam] = 0;
+    if (t.binario && (t.status == RS485_OK)) {
+      const uint8_t *f = (const uint8_t *)t.resposta;
+      uint8_t n = t.tam - 2;
+      if (crc16Modbus(f, n) != (uint16_t)(f[n] | (f[n + 1] << 8))) t.status = RS485_ERRO_CRC;
+    }
+    t.duracao = millis() - inicio;
+    xQueueSend(s_conclusoes, &t, 0);
+  }
+}
+
+//------------------------------------------------------------------------------
+//  iniRS485 - Cria as filas e a task do barramento (Serial2 já iniciada)
+//
+void iniRS485(void) {
+  if (s_taskRS485 != NULL) return;
+
+  s_pedidos = xQueueCreate(RS485_MAX_PEDIDOS, sizeof(RS485_Pedido_Type));
+  s_conclusoes = xQueueCreate(RS485_MAX_PEDIDOS, sizeof(RS485_Transacao_Type));
+
+  Serial2.setRxTimeout(1);                  // fim da resposta: 1 caractere de silêncio
+  Serial2.onReceive(rs485Recebe);
+  xTaskCreate(vTaskRS485, "RS485", configMINIMAL_STACK_SIZE + 2048, NULL, 2, &s_taskRS485);
+}
+
+//------------------------------------------------------------------------------
+//  rs485Pede - Enfileira um pedido ao sensor
+//
+//  endereco: byte enviado ao barramento ('S', 'M', 'T', ...)
+//  prazo:    tempo máximo até o fim da resposta [ms]
+//  binario:  pedido binário (resposta em frame com CRC)
+//
+bool rs485Pede(char endereco, uint16_t prazo, bool binario) {
+  RS485_Pedido_Type p = { endereco, binario, prazo };
+  return (s_pedidos != NULL) && (xQueueSend(s_pedidos, &p, 0) == pdPASS);
+}
+
+//------------------------------------------------------------------------------
+//  rs485Resultado - Retira a próxima transação concluída (na ordem dos pedidos)
+//
+//  espera: tempo máximo de bloqueio [ms]
+//
+bool rs485Resultado(RS485_Transacao_Type &t, uint32_t espera) {
+  return (s_conclusoes != NULL) && (xQueueReceive(s_conclusoes, &t, pdMS_TO_TICKS(espera)) == pdTRUE);
+}
+
+//------------------------------------------------------------------------------
+//  crc16Modbus - CRC-16/Modbus (polinômio 0xA001 refletido, início 0xFFFF)
+//
+uint16_t crc16Modbus(const uint8_t *dados, uint8_t tam) {
+  uint16_t crc = 0xFFFF;
+
+  while (tam--) {
+    crc ^= *dados++;
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+    }
+  }
+  return crc;
+}
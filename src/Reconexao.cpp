@@ -0,0 +1,107 @@
+/**
+ * @file Reconexao.cpp
+ * @brief Implementação do recuo exponencial das tentativas de JOIN
+ * @copyright Copyright (c) 2025
+ */
+
+#include <Arduino.h>
+#include <esp_system.h>
+#include "config.h"
+#include "Logger.h"
+#include "Reconexao.h"
+
+static_assert(JOIN_BACKOFF_MIN >= 2, "JOIN_BACKOFF_MIN inválido");
+static_assert(JOIN_BACKOFF_MAX >= JOIN_BACKOFF_MIN, "JOIN_BACKOFF_MAX deve passar de JOIN_BACKOFF_MIN");
+static_assert(JOIN_BACKOFF_MAX <= 0x7FFFFFFFUL, "JOIN_BACKOFF_MAX acima do alcance dos temporizadores");
+
+#define RECONEXAO_MAGICO   0x4A4F4E31       // "JON1": registro válido
+
+struct Registro_Reconexao_Type {
+  uint32_t magico;
+  uint32_t sorteio;                         // estado do gerador (xorshift32, nunca zero)
+  uint16_t tentativas;                      // JOINs sem sucesso seguidos
+  uint32_t espera;                          // última espera sorteada [ms]
+};
+
+// Sobrevive ao deep sleep e ao reinício por software/watchdog (validado pelo mágico)
+RTC_NOINIT_ATTR static Registro_Reconexao_Type s_reg;
+
+/**
+ * @brief Próximo número do gerador (xorshift32)
+ */
+static uint32_t sorteia(void) {
+  uint32_t x = s_reg.sorteio;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  s_reg.sorteio = x;
+  return x;
+}
+
+/**
+ * @brief Semente: FNV-1a do DevEUI
+ * @note Sem o DevEUI vale o esp_random(), que com o rádio desligado é só pseudoaleatório
+ */
+static uint32_t semente(const char *deveui, uint8_t n) {
+  uint32_t h = 2166136261UL;
+  if (deveui == nullptr) return esp_random() | 1;
+  for (uint8_t i = 0; i < n; i++) {
+    h ^= (uint8_t)deveui[i];
+    h *= 16777619UL;
+  }
+  return h ? h : 1;
+}
+
+/**
+ * @brief Valida o registro e semeia o gerador
+ */
+void iniReconexao(const char *deveui, uint8_t n) {
+  if ((s_reg.magico == RECONEXAO_MAGICO) && (esp_reset_reason() != ESP_RST_POWERON) && (s_reg.sorteio != 0)) {
+    if (s_reg.tentativas) LOGI("COMM", "JOIN: recuo mantido após o reinício (%u tentativas)", (unsigned)s_reg.tentativas);
+    return;
+  }
+  s_reg.magico = RECONEXAO_MAGICO;
+  s_reg.sorteio = semente(deveui, n);
+  s_reg.tentativas = 0;
+  s_reg.espera = 0;
+}
+
+/**
+ * @brief JOIN sem sucesso
+ */
+uint32_t reconexaoFalhou(void) {
+  if (s_reg.tentativas < 0xFFFF) s_reg.tentativas++;
+
+  // JOIN_BACKOFF_MIN * 2^(tentativas - 1), limitado a JOIN_BACKOFF_MAX
+  uint32_t teto = JOIN_BACKOFF_MIN;
+  for (uint16_t i = 1; (i < s_reg.tentativas) && (teto < JOIN_BACKOFF_MAX); i++) teto <<= 1;
+  if (teto > JOIN_BACKOFF_MAX) teto = JOIN_BACKOFF_MAX;
+
+  // Jitter: entre a metade e o teto
+  s_reg.espera = teto / 2 + sorteia() % (teto - teto / 2 + 1);
+  LOGI("COMM", "JOIN: tentativa %u sem sucesso, próxima em %lu s", (unsigned)s_reg.tentativas, (unsigned long)(s_reg.espera / 1000));
+  return s_reg.espera;
+}
+
+/**
+ * @brief Espera antes do primeiro JOIN do boot
+ */
+uint32_t reconexaoEspera(void) {
+  return s_reg.tentativas ? s_reg.espera : 0;
+}
+
+/**
+ * @brief JOIN concluído
+ */
+void reconexaoOk(void) {
+  if (s_reg.tentativas) LOGI("COMM", "JOIN: conectado após %u tentativas sem sucesso", (unsigned)s_reg.tentativas);
+  s_reg.tentativas = 0;
+  s_reg.espera = 0;
+}
+
+/**
+ * @brief JOINs sem sucesso seguidos
+ */
+uint16_t reconexaoTentativas(void) {
+  return s_reg.tentativas;
+}
@@ -0,0 +1,258 @@
+/*
+  --------------------------------------------------------------------------------
+                                                              Início: 17/10/2026
+        Proj.:  WCPendio - Sistema de monitoramento de Taludes e Encostas
+        Fonte:  SPendio.cpp
+        Progs:  Eng. Prof. Nuncio Perrella, MSc e Arnaldo
+        Descr.: Sensores SPendio (RS485) - descoberta dos nós, varredura
+                e negociação do protocolo binário por nó
+                                                              Última: 17/10/2026
+  --------------------------------------------------------------------------------
+        Diario de Bordo
+        ---------------
+  17/10/2026 - Separado de Sensores.cpp
+  17/10/2026 - Negociação binária: timeout não fixa o modo ASCII; nova
+               tentativa a cada SPENDIO_BINARY_RETRY varreduras
+
+*/
+
+#include "Aplic.h"
+#include "config.h"
+#include "Logger.h"
+#include "RS485.h"
+
+// Modo de cada sensor SPendio (memória RTC; renegociado no power-on/reset)
+#define SPENDIO_MODO_DESCONHECIDO 0
+#define SPENDIO_MODO_ASCII        1
+#define SPENDIO_MODO_BINARIO      2
+
+#define SPENDIO_BIN_LEN           8         // endereço + 7 bytes (12+12+12+20 bits)
+#define SPENDIO_PRAZO_MIN         50        // ms - resposta ASCII completa a 4800 bps (~38 ms)
+
+static const char s_enderecos[] = SPENDIO_ENDERECOS;
+static_assert(sizeof(s_enderecos) == SPENDIO_MAX + 1, "SPENDIO_ENDERECOS deve ter SPENDIO_MAX endereços");
+
+// Registro dos nós (memória RTC; descoberta no power-on/reset)
+RTC_DATA_ATTR static uint16_t s_registro;   // bit i = posição i de SPENDIO_ENDERECOS
+RTC_DATA_ATTR static bool s_registroFeito;
+RTC_DATA_ATTR static uint8_t s_modoSPendio[SPENDIO_MAX];
+RTC_DATA_ATTR static uint16_t s_varreduras;  // desde a última tentativa binária dos nós ASCII
+
+static_assert(SPENDIO_BINARY_RETRY >= 1, "SPENDIO_BINARY_RETRY inválido");
+
+
+//-----------------------------------------------------------------------------------------------------
+//      convHStrHInt - Converte string Hexa para int
+//
+int convHStrInt(const char *p, char tam) {
+  int k, num, r, d;
+  r = 0;
+  d = tam - 1;
+  for (k = 0; k < tam; k++) {
+    num = *p - '0';
+    if (num > 9) num = num - 7;
+    num = num << ( d << 2);
+    r = r + num;
+    d--;
+    p++;
+  }
+  return r;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      convSenSPendio - Converte a resposta do Sensor SPendio ("XXX,YYY,ZZZ,SSSSS")
+//
+void convSenSPendio(char s, const char *resposta, SPendio_Amostra_Type &sp) {
+  const char *p;
+
+  p = resposta;
+  LOGD("SENSOR", "Sensor %d", s);
+  LOGD("SENSOR", "%s", resposta);
+
+  sp.acx = convHStrInt(p, 3);                       // x
+  LOGD("SENSOR", "%d,", sp.acx);
+
+  p += 4;
+  sp.acy = convHStrInt(p, 3);                       // y
+  LOGD("SENSOR", "%d,", sp.acy);
+
+  p += 4;
+  sp.acz = convHStrInt(p, 3);                       // z
+  LOGD("SENSOR", "%d,", sp.acz);
+
+  p += 4;
+  sp.solo = convHStrInt(p, 5);                      // solo
+  LOGD("SENSOR", "%lu", (unsigned long)sp.solo);
+
+  sp.valido = true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      convSenSPendioBin - Converte o frame binário do Sensor SPendio
+//
+//  LEN(8) | endereço | acx(12) acy(12) acz(12) solo(20), MSB primeiro | CRC (já conferido)
+//
+bool convSenSPendioBin(char s, const RS485_Transacao_Type &t, SPendio_Amostra_Type &sp) {
+  const uint8_t *f = (const uint8_t *)t.resposta;
+
+  if ((f[0] != SPENDIO_BIN_LEN) || (f[1] != (uint8_t)s)) {
+    LOGW("SENSOR", "Sensor %c: frame binário inválido", s);
+    return false;
+  }
+
+  sp.acx = ((uint16_t)f[2] << 4) | (f[3] >> 4);
+  sp.acy = ((uint16_t)(f[3] & 0x0F) << 8) | f[4];
+  sp.acz = ((uint16_t)f[5] << 4) | (f[6] >> 4);
+  sp.solo = ((uint32_t)(f[6] & 0x0F) << 16) | ((uint32_t)f[7] << 8) | f[8];
+  LOGD("SENSOR", "Sensor %c (bin): %u,%u,%u,%lu", s, sp.acx, sp.acy, sp.acz, (unsigned long)sp.solo);
+
+  sp.valido = true;
+  return true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      posicaoSPendio - Posição do endereço em SPENDIO_ENDERECOS (-1 se não existir)
+//
+static int posicaoSPendio(char endereco) {
+  const char *p = strchr(s_enderecos, endereco);
+  return (p && endereco) ? (int)(p - s_enderecos) : -1;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      contaNos - Número de nós em um mapa de posições
+//
+static uint8_t contaNos(uint16_t mapa) {
+  uint8_t n = 0;
+  for (; mapa; mapa >>= 1) n += mapa & 1;
+  return n;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      descobreSPendio - Descobre os nós SPendio presentes no barramento
+//
+//  Todas as posições de SPENDIO_ENDERECOS recebem um pedido ASCII com prazo
+//  curto, em sequência pela fila do RS485. Feita uma vez após o power-on;
+//  o registro fica na memória RTC. Sem nenhuma resposta, registra S, M e T.
+//
+void descobreSPendio(void) {
+  RS485_Transacao_Type t;
+  uint32_t inicio = millis();
+  uint8_t proximo = 0;
+  int pedidos = 0;
+
+  if (s_registroFeito) return;
+
+  s_registro = 0;
+  for (;;) {
+    while ((proximo < SPENDIO_MAX) && (pedidos < RS485_MAX_PEDIDOS)) {
+      if (!rs485Pede(s_enderecos[proximo], SPENDIO_DISCOVERY_TIMEOUT)) break;
+      proximo++;
+      pedidos++;
+    }
+    if (pedidos == 0) break;
+
+    if (!rs485Resultado(t, (uint32_t)pedidos * SPENDIO_DISCOVERY_TIMEOUT + 100)) {
+      LOGW("SENSOR", "RS485 sem conclusão");
+      break;
+    }
+    pedidos--;
+
+    int i = posicaoSPendio(t.endereco);
+    if ((i >= 0) && (t.status == RS485_OK)) s_registro |= (1U << i);
+  }
+
+  if (s_registro == 0) {
+    s_registro = (1U << NUM_SPENDIO) - 1;
+    LOGW("SENSOR", "Nenhum nó SPendio respondeu: registrando S, M, T");
+  }
+  s_registroFeito = true;
+  LOGI("SENSOR", "SPendio: %u nós registrados (mapa 0x%04X, %lu ms)", (unsigned)contaNos(s_registro),
+       (unsigned)s_registro, (unsigned long)(millis() - inicio));
+
+#if PAYLOAD_FRAME_FORMAT != 5
+  if (s_registro >> NUM_SPENDIO) LOGW("SENSOR", "Nós além de S, M, T só são enviados no frame v05 (PAYLOAD_FRAME_FORMAT 5)");
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      registroSPendio - Posições registradas (bit i = posição i de SPENDIO_ENDERECOS)
+//
+uint16_t registroSPendio(void) {
+  return s_registro;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//      varrSensoresSPendio - Varre Sensores SPendio
+//
+//  Os pedidos dos nós registrados vão para a fila do RS485 (até
+//  RS485_MAX_PEDIDOS por vez); cada pedido é enviado assim que a resposta
+//  anterior termina. O prazo de cada nó divide SPENDIO_SCAN_BUDGET entre os
+//  nós (entre SPENDIO_PRAZO_MIN e SPENDIO_TIMEOUT), limitando a varredura.
+//
+//  Nó de modo desconhecido recebe o pedido binário; se não responder, o
+//  pedido ASCII é refeito na mesma varredura e o nó só passa a ASCII se
+//  responder a ele (sem resposta continua desconhecido). A cada
+//  SPENDIO_BINARY_RETRY varreduras os nós ASCII recebem de novo o pedido
+//  binário (sensor atualizado ou que perdeu a primeira negociação).
+//
+void varrSensoresSPendio(CPendio_Amostra_Type &amostra) {
+  RS485_Transacao_Type t;
+  uint32_t inicio = millis();
+  uint8_t nos = contaNos(s_registro);
+  uint32_t prazo = nos ? SPENDIO_SCAN_BUDGET / nos : SPENDIO_TIMEOUT;
+  uint8_t proximo = 0;
+  int pedidos = 0;
+  bool tentaBinario = SPENDIO_BINARY_ENABLED && (++s_varreduras >= SPENDIO_BINARY_RETRY);
+
+  if (tentaBinario) s_varreduras = 0;
+  if (prazo > SPENDIO_TIMEOUT) prazo = SPENDIO_TIMEOUT;
+  if (prazo < SPENDIO_PRAZO_MIN) prazo = SPENDIO_PRAZO_MIN;
+
+  memset(amostra.spendio, 0, sizeof(amostra.spendio));
+
+  for (;;) {
+    while ((proximo < SPENDIO_MAX) && (pedidos < RS485_MAX_PEDIDOS)) {
+      if (s_registro & (1U << proximo)) {
+        bool binario = SPENDIO_BINARY_ENABLED && ((s_modoSPendio[proximo] != SPENDIO_MODO_ASCII) || tentaBinario);
+        if (!rs485Pede(s_enderecos[proximo], (uint16_t)prazo, binario)) break;
+        pedidos++;
+      }
+      proximo++;
+    }
+    if (pedidos == 0) break;
+
+    if (!rs485Resultado(t, (uint32_t)pedidos * prazo + 100)) {
+      LOGW("SENSOR", "RS485 sem conclusão");
+      break;
+    }
+    pedidos--;
+
+    int i = posicaoSPendio(t.endereco);
+    if (i < 0) continue;
+
+    if (t.status == RS485_OK) {
+      if (t.binario) {
+        if (convSenSPendioBin(t.endereco, t, amostra.spendio[i]) && (s_modoSPendio[i] != SPENDIO_MODO_BINARIO)) {
+          s_modoSPendio[i] = SPENDIO_MODO_BINARIO;
+          LOGI("SENSOR", "Sensor %c: modo binário", t.endereco);
+        }
+      }
+      else {
+        convSenSPendio(t.endereco, t.resposta, amostra.spendio[i]);
+        if (SPENDIO_BINARY_ENABLED && (s_modoSPendio[i] == SPENDIO_MODO_DESCONHECIDO)) {
+          s_modoSPendio[i] = SPENDIO_MODO_ASCII;                 // respondeu ao ASCII, não ao binário
+          LOGI("SENSOR", "Sensor %c: modo ASCII", t.endereco);
+        }
+      }
+    }
+    else if (t.binario && (t.status == RS485_TIMEOUT) && (s_modoSPendio[i] != SPENDIO_MODO_BINARIO)) {
+      if (rs485Pede(t.endereco, (uint16_t)prazo)) pedidos++;    // pedido ASCII na mesma varredura
+    }
+    else {
+      LOGD("SENSOR", "Sensor %c: %s (%lu ms)", t.endereco,
+           (t.status == RS485_TIMEOUT) ? "sem resposta" :
+           (t.status == RS485_ERRO_CRC) ? "erro de CRC" : "resposta longa", (unsigned long)t.duracao);
+    }
+  }
+  LOGD("SENSOR", "Varredura SPendio: %u nós, %lu ms", (unsigned)nos, (unsigned long)(millis() - inicio));
+}
@@ -5,8 +5,8 @@
         Fonte:  Sensores.cpp
         Progs:  Eng. Prof. Nuncio Perrella, MSc e Arnaldo
         Descr.: Funções de tratamento dos sensores
-                Varredura Sensores T,M,S (SPendio)
-                                                              Última: 16/12/2023
+                AHT, BMP280, bateria e chuva (SPendio em SPendio.cpp)
+                                                              Última: 17/10/2026
   --------------------------------------------------------------------------------
         Diario de Bordo
         ---------------
@@ -15,376 +15,315 @@
   15/12/2023 - Sensor de pressão
   15/12/2023 - Sensor de bateria
   16/12/2023 - Sensor de chuva
+  17/10/2026 - Leituras numéricas (CPendio_Amostra_Type); formatação em Payload.cpp
+  17/10/2026 - SPendio por transações RS485 dirigidas por evento (RS485.cpp)
+  17/10/2026 - Protocolo SPendio binário com CRC, negociado por sensor
+  17/10/2026 - Registro de até 16 nós SPendio com descoberta no power-on
+  17/10/2026 - AHT em duas fases: conversão sobreposta ao RS485 e ao BMP280
+  17/10/2026 - BMP280 em modo forçado, leitura única de temperatura e pressão
+  17/10/2026 - Compensação inteira do BMP280 e do AHT20 (sem float)
+  17/10/2026 - Bateria pelo ADC contínuo (Bateria.cpp), leitura sem bloqueio
+  17/10/2026 - Barramentos em paralelo: task I2C junto com o RS485, com prazo
+  17/10/2026 - Cache dos sensores: período de leitura e TTL por sensor
+  17/10/2026 - SPendio pela janela de amostragem contínua (Inclinacao.cpp)
+  17/10/2026 - Varredura e negociação dos SPendio em SPendio.cpp
 
 */
 
 #include "Aplic.h"
+#include "config.h"
 #include "Logger.h"
+#include "RS485.h"
+#include "PowerManager.h"
+#include <freertos/queue.h>
+
+static bool s_ahtDisparado;                 // conversão do AHT em andamento
+
+// Barramento I2C (AHT + BMP280) lido pela task I2C, em paralelo ao RS485
+#define I2C_AHT                   0x01      // pedido: temperatura e umidade
+#define I2C_BMP                   0x02      // pedido: pressão
+
+struct Leitura_I2C_Type {
+  uint32_t lidos;                           // I2C_AHT | I2C_BMP
+  int16_t temp;                             // 0,1 °C
+  uint8_t umid;                             // %
+  uint32_t pressao;                         // Pa
+  uint32_t duracao;                         // [ms]
+};
+
+static TaskHandle_t s_taskI2C = NULL;
+static QueueHandle_t s_leituraI2C = NULL;   // uma leitura (a mais recente)
+
+static_assert(SENSOR_SCAN_DEADLINE >= AHTX0_MEASUREMENT_TIMEOUT + BMP280_MEASUREMENT_TIMEOUT,
+              "SENSOR_SCAN_DEADLINE menor que o pior caso do barramento I2C");
+
+// Cache dos sensores (memória RTC): cada sensor é lido só quando o valor
+// guardado completa o seu período; depois do TTL sem leitura boa o valor
+// guardado vai para a amostra como falha.
+typedef enum {
+  CACHE_SPENDIO = 0,
+  CACHE_TEMP_UMID,
+  CACHE_PRESSAO,
+  CACHE_BATERIA,
+  CACHE_SENSORES
+} t_eCacheSensor;
+
+#define CACHE_TOLERANCIA          2000      // ms - varredura um pouco adiantada ainda lê o sensor
+
+struct Cache_Sensor_Type {
+  bool valido;
+  uint32_t tempo;                           // rtcMillis() da última leitura boa
+};
+
+struct Tempos_Sensor_Type {
+  uint32_t periodo;                         // [s]
+  uint32_t ttl;                             // [s]
+};
+
+static const Tempos_Sensor_Type s_tempos[CACHE_SENSORES] = {
+  { SENSOR_PERIOD_SPENDIO,   SENSOR_TTL_SPENDIO },
+  { SENSOR_PERIOD_TEMP_UMID, SENSOR_TTL_TEMP_UMID },
+  { SENSOR_PERIOD_PRESSURE,  SENSOR_TTL_PRESSURE },
+  { SENSOR_PERIOD_BATTERY,   SENSOR_TTL_BATTERY },
+};
+
+static_assert((SENSOR_TTL_SPENDIO >= SENSOR_PERIOD_SPENDIO) && (SENSOR_TTL_TEMP_UMID >= SENSOR_PERIOD_TEMP_UMID)
+              && (SENSOR_TTL_PRESSURE >= SENSOR_PERIOD_PRESSURE) && (SENSOR_TTL_BATTERY >= SENSOR_PERIOD_BATTERY),
+              "SENSOR_TTL_* menor que o SENSOR_PERIOD_* correspondente");
+
+RTC_DATA_ATTR static Cache_Sensor_Type s_cache[CACHE_SENSORES];
+RTC_DATA_ATTR static CPendio_Amostra_Type s_valores;   // últimas leituras boas
 
-const uchar TabHexa[] = {"0123456789ABCDEF"};
-char inputBuffer[32];
-int16_t contChuva;
-static t_eChuvaEstado eChuvaEstado = E_CHUVA_REPOUSO;
-static uint cdeb;                           // contador debounce
 TaskHandle_t taskScanSensorHandle = NULL;
-TaskHandle_t taskVarreSensorChuvaHandle = NULL;
 
 
 //------------------------------------------------------------------------------
 //  iniSensores - Inicializa sensores
 //
-void iniSensores(CPendio_Sensor_Data_Type &dado) {
-  dado.frmFmtV[0] = '0';                  // Frame Format Version 0x01
-  dado.frmFmtV[1] = '1';
-  contChuva = 0;                          // Inicializa contador de chuva
+void iniSensores(void) {
   g_bDiag = false;                            // Modo diagnóstico desativado
-  xTaskCreate(vTaskVarreSensorChuva, "SENSOR CHUVA", configMINIMAL_STACK_SIZE + 1024, NULL, 1, &taskVarreSensorChuvaHandle);
-  eChuvaEstado = E_CHUVA_INICIA;
-}
-
-//------------------------------------------------------------------------------
-//  vTaskVarreSensorChuva - Task de Varredura do Sensor de chuva
-//
-void vTaskVarreSensorChuva(void *pvParameters)
-{
-  int cont = 0;
-  TickType_t xLastWakeTime;
-  xLastWakeTime = xTaskGetTickCount();
-  while (1)
-  {
-    switch (eChuvaEstado) {
-      case E_CHUVA_REPOUSO:
-        break;
-      case E_CHUVA_INICIA:
-        cdeb = DEBDmax;
-        eChuvaEstado = E_CHUVA_TEM;
-        break;
-      case E_CHUVA_TEM:                         // Tem chuva?
-        if (!temChuva()) {
-          if (cdeb) cdeb--;                     // não, aguarda depressionar
-          else desWLED();
-        }
-        else {
-          if (!cdeb) {
-            cdeb = DEBPmax;                     // Sim há uma possibilidade de Chuva...
-            eChuvaEstado = E_CHUVA_ESTAB;
-          }
-          else cdeb = DEBDmax;                  // Ruído, reinicia debouncing
-        }
-        break;
-      case E_CHUVA_ESTAB:                       // Chuva estável?
-        if (temChuva()) {
-          if (cdeb) cdeb--;                     // aguarda debouncing
-          else {
-            ligWLED();
-            eChuvaEstado = E_CHUVA_ANALISE;     // Sim...
-          }
-        }
-        else {
-          cdeb = DEBPmax;                       // Ruído, reinicia debouncing
-        }
-        break;
-      case E_CHUVA_ANALISE:
-        if (temChuva()) {
-          cdeb++;
-        }
-        else {
-          if (cdeb > TEMPO_DIAG) g_bDiag = true;  // Modo diagnóstico
-          else contChuva++;                       // incrementa contador
-          eChuvaEstado = E_CHUVA_INICIA;          // reinicia...
-        }
-        break;
-    }
-    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(1));
-  }
-}
-
-//------------------------------------------------------------------------------
-//      int16Hex - Converte int8 em ASCII Hexa
-//
-void int16Hex(int16_t c, char *p) {
-  uchar b;
-  b = c >> 8;
-  *p = Nib(b / 16);
-  p++;
-  *p = Nib(b % 16);
-  p++;
-  b = (char)c;
-  *p = Nib(b / 16);
-  p++;
-  *p = Nib(b % 16);
-}
-
-//------------------------------------------------------------------------------
-//      int8Hex - Converte int8 em ASCII Hexa
-//
-void int8Hex(int8_t c, char *p) {
-  *p = Nib(c / 16);
-  p++;
-  *p = Nib((c & 0x0f));
+  iniChuva();                             // Inicializa o pluviômetro (contador mantido no deep sleep)
+  iniBateria();                           // ADC contínuo da bateria (filtrado em segundo plano)
+  iniRS485();                             // Transações do barramento dos sensores SPendio
+  iniI2C();                               // Task do barramento I2C (AHT + BMP280)
+  descobreSPendio();                      // Registro dos nós (só no power-on/reset)
+  iniInclinacao();                        // Amostragem contínua dos SPendio (dona do RS485)
 }
 
 //-----------------------------------------------------------------------------------------------------
 //      leSenChuva - le Sensor de Chuva
 //
-void leSenChuva(char *p) {
+uint16_t leSenChuva(void) {
   //contChuva++;
-  int16Hex(contChuva, p);
+  atualizaChuva();                        // transfere as básculas da interrupção
+  return (uint16_t)contChuva;
 }
 
 //-----------------------------------------------------------------------------------------------------
 //      leSenBateria - le Sensor de Bateria
 //
-void leSenBateria(char *p) {
-  uchar b, c;
-  int16_t vBat;
-  int32_t soma=0;
-  for (int i = 0; i < 8; i++) {
-    soma += analogReadMilliVolts(aVBat);
-    delay(1);                           // 1 ms
+uint16_t leSenBateria(void) {
+  uint16_t vBat;
+
+  if (!bateriaMilliVolts(vBat)) {              // último valor filtrado (ADC contínuo)
+    LOGW("SENSOR", "VBAT ainda não disponível");
+    return 0;
   }
-  vBat = int16_t(soma >> 3);                   // média de 8
   if (vBat > 4095) vBat = 4095;                // limita 4095 (12 bits) 
   LOGD("SENSOR", "VBAT ADC=%d V=%ld mV", vBat, (long)(FATOR_VBAT * vBat));
 //  vBat /= 10;                                  // desconsidera uma casa decimal
-  b = (uchar) vBat;
-  vBat = vBat >> 8;
-  *p     =   TabHexa[vBat & 0x0f];
-  *(p + 1) = TabHexa[(b >> 4) & 0x0f];
-  *(p + 2) = TabHexa[b & 0x0f];
+  return vBat;
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      mostraBufferLora - mostra Buffer LoRa
+//      disparaTempUmid - Inicia a conversão do Sensor Temperatura e Umidade (~80 ms)
 //
-void mostraBufferLora(CPendio_Sensor_Data_Type &dado) {
-  LOGD("SENSOR", "%s", dado.bytes_B);
+void disparaTempUmid(void) {
+  s_ahtDisparado = aht.startMeasurement();
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      mostraVetorAscii - mostra um vetor ASCII
+//      leSenTempUmid - le Sensor Temperatura e Umidade (conversão iniciada em disparaTempUmid)
 //
-void mostraVetorAscii(char *p, char tam) {
-  for (int i = 0; i < tam; i++) {
-    LOGD("SENSOR", "%c", *p);
-  }
-}
-
-//-----------------------------------------------------------------------------------------------------
-//      leSenTempUmid - le Sensor Temperatura e Umidade
-//
-void leSenTempUmid(char *t, char *u) {
-  sensors_event_t humidity, temperature;
-  uchar tempC;
-  int8_t umid;
-
-  if (aht.getEvent(&humidity, &temperature)) {
-    tempC = (char) temperature.temperature;
-    umid  = (char) humidity.relative_humidity;
-    LOGD("SENSOR", "%d*C %d%%", (int)tempC, (int)umid);
+void leSenTempUmid(int16_t &t, uint8_t &u) {
+  int32_t centi;                                    // 0,01 °C
+  uint16_t permil;                                  // 0,1 %UR
+
+  if (s_ahtDisparado && aht.readMeasurementInt(&centi, &permil)) {
+    t = (int16_t)(centi / 10);                      // 0,1 °C
+    u = (uint8_t)(permil / 10);
+    LOGD("SENSOR", "%s%d.%d*C %d%%", (t < 0) ? "-" : "", abs(t) / 10, abs(t) % 10, (int)u);
   }
   else {
-    tempC = -100;
-    umid = 0;
+    t = TEMP_FALHA;
+    u = 0;
     LOGD("SENSOR", "Temperatura/Umidade não disponível");
-    LOGD("SENSOR", "%d*C %d%%", (int)tempC, (int)umid);
+    LOGD("SENSOR", "%d*C %d%%", t / 10, (int)u);
     LOGW("SENSOR", "Humidity and temperature read fail");
   }
-  *t       = TabHexa[(tempC >> 4) & 0x0f];
-  *(t + 1) = TabHexa[(tempC & 0x0f)];
-  *u       = TabHexa[(umid >> 4) & 0x0f];
-  *(u + 1) = TabHexa[(umid & 0x0f)];
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      leSenTempPress - le Sensor Temperatura e Pressao
+//      disparaTempPress - Inicia a conversão do Sensor Temperatura e Pressao (modo forçado, ~40 ms)
 //
-void leSenTempPress(char *p) {
-  int32_t pressao;
-  uchar b, c;
+void disparaTempPress(void) {
+  if (g_bBMPPresente) bmp.startForcedMeasurement();
+}
 
-  if (g_bBMPPresente) {
-    LOGD("SENSOR", "Temperature = %.2f *C", bmp.readTemperature());
+//-----------------------------------------------------------------------------------------------------
+//      leSenTempPress - le Sensor Temperatura e Pressao (conversão iniciada em disparaTempPress)
+//
+uint32_t leSenTempPress(void) {
+  uint32_t pressao;
+  int32_t t;                                        // 0,01 °C
 
-    pressao = (uint32_t)bmp.readPressure();
+  if (g_bBMPPresente && bmp.readAllInt(&t, &pressao)) {   // compensação inteira de 32 bits
+    LOGD("SENSOR", "Temperature = %s%ld.%02ld *C", (t < 0) ? "-" : "", (long)(labs(t) / 100), (long)(labs(t) % 100));
     LOGD("SENSOR", "Pressure = %lu Pa", (unsigned long)pressao);
-
-    LOGD("SENSOR", "Approx altitude = %.2f m", bmp.readAltitude(1013.25));
-
-    c = (char) pressao;
-    pressao = pressao >> 8;
-    b = (char) pressao;
-    pressao = pressao >> 8;
-    *p     = TabHexa[pressao & 0x0f];
-    *(p + 1) = TabHexa[(b >> 4) & 0x0f];
-    *(p + 2) = TabHexa[b & 0x0f];
-    *(p + 3) = TabHexa[(c >> 4) & 0x0f];
-    *(p + 4) = TabHexa[c & 0x0f];
   }
   else {
     LOGW("SENSOR", "Temperatura e Pressao falha!");
-    *p     = '0';
-    *(p + 1) = '0';
-    *(p + 2) = '0';
-    *(p + 3) = '0';
-    *(p + 4) = '0';
+    pressao = 0;
   }
+  return pressao;
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      zeraBufferLora - zera Buffer LoRa
+//      vTaskI2C - Lê o barramento I2C a cada pedido de varredura
 //
-void zeraBufferLora(char *p, int tam) {
-  for (int i = 0; i < tam; i++) {
-    *p = '0';
-    p++;
-  }
-}
-
-//-----------------------------------------------------------------------------------------------------
-//      bufferLora - Monta Buffer LoRa
+//  O valor da notificação diz quais sensores ler (I2C_AHT, I2C_BMP). Os
+//  dois convertem juntos; a coleta de cada um espera a própria conversão.
+//  O resultado vai para s_leituraI2C (sobrescreve a anterior).
 //
-void bufferLora(char *p, int tam) {
-  for (int i = 0; i < tam; i++) {
-    if (inputBuffer[i] != ',') {
-      *p = inputBuffer[i];
-      p++;
-    }
-  }
-}
+static void vTaskI2C(void *pvParameters) {
+  Leitura_I2C_Type r;
 
-//-----------------------------------------------------------------------------------------------------
-//      convHStrHInt - Converte string Hexa para int
-//
-int convHStrInt(char *p, char tam) {
-  int k, num, r, d;
-  r = 0;
-  d = tam - 1;
-  for (k = 0; k < tam; k++) {
-    num = *p - '0';
-    if (num > 9) num = num - 7;
-    num = num << ( d << 2);
-    r = r + num;
-    d--;
-    p++;
+  for (;;) {
+    xTaskNotifyWait(0, 0xFFFFFFFF, &r.lidos, portMAX_DELAY);
+    uint32_t inicio = millis();
+
+    if (r.lidos & I2C_AHT) disparaTempUmid();
+    if (r.lidos & I2C_BMP) disparaTempPress();
+    if (r.lidos & I2C_BMP) r.pressao = leSenTempPress();          // Sensores de temperatura e pressão
+    if (r.lidos & I2C_AHT) leSenTempUmid(r.temp, r.umid);         // Sensores de temperatura e umidade (coleta)
+
+    r.duracao = millis() - inicio;
+    xQueueOverwrite(s_leituraI2C, &r);
   }
-  return r;
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      mostraSenSPendio - Mostra Sensores SPendio
+//      iniI2C - Cria a task do barramento I2C
 //
-void mostraSenSPendio(char s) {
-  char *p;
-  int16_t num;
-  int32_t solo;
+void iniI2C(void) {
+  if (s_taskI2C != NULL) return;
 
-  p = inputBuffer;
-  LOGD("SENSOR", "Sensor %d", s);
-  LOGD("SENSOR", "%s", inputBuffer);
-
-  num = convHStrInt(p, 3);                          // x
-  LOGD("SENSOR", "%d,", num);
-
-  p += 4;
-  num = convHStrInt(p, 3);                          // y
-  LOGD("SENSOR", "%d,", num);
-
-  p += 4;
-  num = convHStrInt(p, 3);                          // z
-  LOGD("SENSOR", "%d,", num);
-
-  p += 4;
-  solo = convHStrInt(p, 5);                         // solo
-  LOGD("SENSOR", "%d", solo);
+  s_leituraI2C = xQueueCreate(1, sizeof(Leitura_I2C_Type));
+  xTaskCreate(vTaskI2C, "I2C", configMINIMAL_STACK_SIZE + 2048, NULL, 1, &s_taskI2C);
 }
 
-//------------------------------------------------------------------------------
-//  rs485_TX - Habilita Transmissão RS485
-//
-void rs485_TX(void) {
-  digitalWrite(nRE, HIGH);
-  digitalWrite(pDE, HIGH);
-}
-
-//------------------------------------------------------------------------------
-//  rs485_RX - Habilita Recepção RS485
+//-----------------------------------------------------------------------------------------------------
+//      cacheVencido - O sensor completou o período (ou não tem valor guardado)
 //
-void rs485_RX(void) {
-  digitalWrite(pDE, LOW);
-  digitalWrite(nRE, LOW);
+static bool cacheVencido(t_eCacheSensor c, uint32_t agora) {
+  return !s_cache[c].valido || ((agora - s_cache[c].tempo + CACHE_TOLERANCIA) >= s_tempos[c].periodo * 1000UL);
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      leSenSPendio - le Sensor SPendio
+//      cacheAtualiza - Leitura boa: reinicia o período do sensor
 //
-bool leSenSPendio(char sensor) {
-  int timeout, num;
-  rs485_TX();
-  //delay(10);
-  Serial2.write(sensor);
-  Serial2.flush();
-  rs485_RX();
-  timeout = SPENDIO_TIMEOUT;
-  while (timeout) {
-    if (Serial2.available() > 0) {
-      num = Serial2.readBytesUntil(LF, inputBuffer, sizeof(inputBuffer));
-      return true;
-      break;
-    }
-    delay(10);
-    timeout--;
-  }
-  return false;
+static void cacheAtualiza(t_eCacheSensor c, uint32_t agora) {
+  s_cache[c].valido = true;
+  s_cache[c].tempo = agora;
 }
 
 //-----------------------------------------------------------------------------------------------------
-//      varrSensoresSPendio - Varre Sensores SPendio
+//      cacheExpirado - Valor guardado sem leitura boa há mais que o TTL
 //
-void varrSensoresSPendio(CPendio_Sensor_Data_Type &dado) {
-  if (leSenSPendio('S')) {                    // Sensor SPendio S
-    mostraSenSPendio('S');
-    bufferLora(dado.bytes_B, 17);
-  }
-  else {
-    zeraBufferLora(dado.bytes_B, 14);
-  }
-
-  if (leSenSPendio('M')) {                    // Sensor SPendio M
-    mostraSenSPendio('M');
-    bufferLora(dado.bytes_M, 17);
-  }
-  else {
-    zeraBufferLora(dado.bytes_M, 14);
-  }
-
-  if (leSenSPendio('T')) {                    // Sensor SPendio T
-    mostraSenSPendio('T');
-    bufferLora(dado.bytes_T, 17);
-  }
-  else {
-    zeraBufferLora(dado.bytes_T, 14);
-  }
+static bool cacheExpirado(t_eCacheSensor c, uint32_t agora) {
+  return !s_cache[c].valido || ((agora - s_cache[c].tempo) > s_tempos[c].ttl * 1000UL);
 }
 
 //-----------------------------------------------------------------------------------------------------
 //      varrSensores - Varre Sensores
 //
-void varrSensores(CPendio_Sensor_Data_Type &dado) {
+//  Só os sensores com o período vencido são lidos; os demais entram na
+//  amostra pelo cache, sem acordar o barramento. Cada barramento anda por
+//  conta própria: a task I2C lê AHT e BMP280 enquanto esta task conduz os
+//  pedidos RS485 (task RS485) e copia os valores do ADC (task BAT) e do
+//  pluviômetro. A varredura termina no barramento mais lento, limitada a
+//  SENSOR_SCAN_DEADLINE; leitura I2C fora do prazo conta como falha.
+//
+void varrSensores(CPendio_Amostra_Type &amostra) {
+  Leitura_I2C_Type i2c = Leitura_I2C_Type();
+  uint32_t inicio = millis();
+  uint32_t agora = PowerManager::rtcMillis();
+  uint32_t pedidoI2C = (cacheVencido(CACHE_TEMP_UMID, agora) ? I2C_AHT : 0)
+                     | (cacheVencido(CACHE_PRESSAO, agora) ? I2C_BMP : 0);
   ligLLED();
 
-  varrSensoresSPendio(dado);                  // Sensores SPendio
-
-  leSenTempUmid(dado.temp, dado.umid);        // Sensores de temperatura e umidade
-
-  leSenTempPress(dado.pressao);               // Sensores de temperatura e pressão
+  if (pedidoI2C) {
+    xQueueReset(s_leituraI2C);                // descarta leitura atrasada
+    xTaskNotify(s_taskI2C, pedidoI2C, eSetValueWithOverwrite);   // I2C: AHT e/ou BMP280
+  }
 
-  leSenChuva(dado.pluv);                      // Sensor de chuva
+  bool leSPendio = cacheVencido(CACHE_SPENDIO, agora);
+  bool leBat = cacheVencido(CACHE_BATERIA, agora);
 
-  leSenBateria(dado.bat);                     // Sensor de bateria
+  uint32_t tRS485 = millis();
+  if (leSPendio) {
+    inclinacaoJanela(s_valores);              // RS485: sensores SPendio (resumo da janela)
+    cacheAtualiza(CACHE_SPENDIO, agora);      // falha de um nó fica no próprio nó (valido)
+  }
+  tRS485 = millis() - tRS485;
+
+  uint32_t tADC = millis();
+  s_valores.pluv = leSenChuva();              // Sensor de chuva (contador, sempre atual)
+  if (leBat) {
+    uint16_t bat = leSenBateria();            // Sensor de bateria
+    if (bat) {
+      s_valores.bat = bat;
+      cacheAtualiza(CACHE_BATERIA, agora);
+    }
+  }
+  tADC = millis() - tADC;
+
+  if (pedidoI2C) {
+    uint32_t decorrido = millis() - inicio;
+    uint32_t espera = (decorrido < SENSOR_SCAN_DEADLINE) ? SENSOR_SCAN_DEADLINE - decorrido : 0;
+    if (xQueueReceive(s_leituraI2C, &i2c, pdMS_TO_TICKS(espera)) == pdTRUE) {
+      if ((i2c.lidos & I2C_AHT) && (i2c.temp != TEMP_FALHA)) {
+        s_valores.temp = i2c.temp;
+        s_valores.umid = i2c.umid;
+        cacheAtualiza(CACHE_TEMP_UMID, agora);
+      }
+      if ((i2c.lidos & I2C_BMP) && (i2c.pressao != 0)) {
+        s_valores.pressao = i2c.pressao;
+        cacheAtualiza(CACHE_PRESSAO, agora);
+      }
+    }
+    else {
+      i2c.duracao = millis() - inicio;
+      LOGW("SENSOR", "I2C fora do prazo (%u ms)", (unsigned)SENSOR_SCAN_DEADLINE);
+    }
+  }
 
-  dado.final = 0;                             // Finalizador
+  amostra = s_valores;
+  if (cacheExpirado(CACHE_SPENDIO, agora)) {
+    memset(amostra.spendio, 0, sizeof(amostra.spendio));
+    memset(amostra.estat, 0, sizeof(amostra.estat));
+    amostra.janela = 0;
+  }
+  if (cacheExpirado(CACHE_TEMP_UMID, agora)) {
+    amostra.temp = TEMP_FALHA;
+    amostra.umid = 0;
+  }
+  if (cacheExpirado(CACHE_PRESSAO, agora)) amostra.pressao = 0;
+  if (cacheExpirado(CACHE_BATERIA, agora)) amostra.bat = 0;
 
-  //mostraBufferLora(dado);
   desLLED();
+  LOGD("SENSOR", "Varredura: %lu ms (RS485 %lu, I2C %lu, ADC %lu ms; lidos:%s%s%s%s)",
+       (unsigned long)(millis() - inicio), (unsigned long)tRS485, (unsigned long)i2c.duracao, (unsigned long)tADC,
+       leSPendio ? " SPendio" : "", (pedidoI2C & I2C_AHT) ? " AHT" : "", (pedidoI2C & I2C_BMP) ? " BMP" : "",
+       leBat ? " VBAT" : "");
 }
@@ -0,0 +1,215 @@
+/**
+ * @file Temporizador.cpp
+ * @brief Implementação da roda hierárquica de temporizadores
+ * @copyright Copyright (c) 2025
+ */
+
+#include <Arduino.h>
+#include "Temporizador.h"
+
+#define NIVEIS      4                       // 4 x 8 bits = 32 bits de tempo
+#define BITS_NIVEL  8
+#define SLOTS       (1 << BITS_NIVEL)
+#define VAZIO       0xFF                    // fim da lista
+
+static_assert(TEMPORIZADOR_MAX < VAZIO, "TEMPORIZADOR_MAX maior que o índice das listas");
+
+struct Temporizador_Type {
+  Temporizador_Cb cb;
+  void *arg;
+  uint32_t prazo;                           // [ms]
+  uint32_t periodo;                         // [ms] (0 = uma vez)
+  uint8_t prox, ant;                        // lista do compartimento
+  uint8_t nivel, slot;
+  bool acorda;                              // limita o deep sleep
+  bool criado;
+  bool armado;
+};
+
+static Temporizador_Type s_tmr[TEMPORIZADOR_MAX];
+static uint8_t s_cabeca[NIVEIS][SLOTS];     // primeiro temporizador de cada compartimento
+static uint32_t s_ocupado[NIVEIS][SLOTS / 32];   // mapa de compartimentos não vazios
+static uint32_t s_base;                     // primeiro ms ainda não processado por completo
+static bool s_iniciada;
+
+/**
+ * @brief Coloca o temporizador no compartimento da distância até o prazo
+ */
+static void liga(uint8_t i) {
+  Temporizador_Type &t = s_tmr[i];
+  uint32_t delta = t.prazo - s_base;
+  uint8_t n = 0;
+
+  if ((int32_t)delta < 0) t.slot = s_base & (SLOTS - 1);          // vencido: próximo processamento
+  else {
+    while ((n < NIVEIS - 1) && (delta >> (BITS_NIVEL * (n + 1)))) n++;
+    t.slot = (t.prazo >> (BITS_NIVEL * n)) & (SLOTS - 1);
+  }
+  t.nivel = n;
+  t.ant = VAZIO;
+  t.prox = s_cabeca[n][t.slot];
+  if (t.prox != VAZIO) s_tmr[t.prox].ant = i;
+  s_cabeca[n][t.slot] = i;
+  s_ocupado[n][t.slot >> 5] |= (1UL << (t.slot & 31));
+}
+
+/**
+ * @brief Retira o temporizador do compartimento
+ */
+static void desliga(uint8_t i) {
+  Temporizador_Type &t = s_tmr[i];
+
+  if (t.ant != VAZIO) s_tmr[t.ant].prox = t.prox;
+  else s_cabeca[t.nivel][t.slot] = t.prox;
+  if (t.prox != VAZIO) s_tmr[t.prox].ant = t.ant;
+  if (s_cabeca[t.nivel][t.slot] == VAZIO) s_ocupado[t.nivel][t.slot >> 5] &= ~(1UL << (t.slot & 31));
+}
+
+/**
+ * @brief Desce os temporizadores de um compartimento para os níveis de baixo
+ */
+static void cascata(uint8_t n, uint8_t slot) {
+  uint8_t i = s_cabeca[n][slot];
+
+  s_cabeca[n][slot] = VAZIO;
+  s_ocupado[n][slot >> 5] &= ~(1UL << (slot & 31));
+  while (i != VAZIO) {
+    uint8_t prox = s_tmr[i].prox;
+    liga(i);
+    i = prox;
+  }
+}
+
+/**
+ * @brief Primeiro compartimento ocupado do nível n a partir de de (SLOTS se nenhum)
+ */
+static uint16_t proximoOcupado(uint8_t n, uint16_t de) {
+  for (uint16_t w = de >> 5; w < SLOTS / 32; w++) {
+    uint32_t m = s_ocupado[n][w];
+    if (w == (de >> 5)) m &= ~0UL << (de & 31);
+    if (m) return w * 32 + __builtin_ctz(m);
+  }
+  return SLOTS;
+}
+
+/**
+ * @brief Cria um temporizador
+ */
+int8_t temporizadorCria(Temporizador_Cb cb, bool acorda, void *arg) {
+  if (!s_iniciada) {
+    memset(s_cabeca, VAZIO, sizeof(s_cabeca));
+    s_base = millis();
+    s_iniciada = true;
+  }
+  for (uint8_t i = 0; i < TEMPORIZADOR_MAX; i++) {
+    if (s_tmr[i].criado) continue;
+    s_tmr[i].cb = cb;
+    s_tmr[i].arg = arg;
+    s_tmr[i].acorda = acorda;
+    s_tmr[i].armado = false;
+    s_tmr[i].criado = true;
+    return i;
+  }
+  return -1;
+}
+
+/**
+ * @brief Arma um temporizador
+ */
+void temporizadorArma(int8_t id, uint32_t prazo, uint32_t periodo) {
+  if ((id < 0) || (id >= TEMPORIZADOR_MAX) || !s_tmr[id].criado) return;
+
+  Temporizador_Type &t = s_tmr[id];
+  if (t.armado) desliga(id);
+  t.prazo = prazo;
+  t.periodo = periodo;
+  t.armado = true;
+  liga(id);
+}
+
+/**
+ * @brief Desarma um temporizador
+ */
+void temporizadorDesarma(int8_t id) {
+  if ((id < 0) || (id >= TEMPORIZADOR_MAX) || !s_tmr[id].armado) return;
+
+  desliga(id);
+  s_tmr[id].armado = false;
+}
+
+/**
+ * @brief Tempo até o vencimento
+ */
+uint32_t temporizadorRestante(int8_t id) {
+  if ((id < 0) || (id >= TEMPORIZADOR_MAX) || !s_tmr[id].armado) return 0;
+
+  int32_t d = (int32_t)(s_tmr[id].prazo - millis());
+  return (d > 0) ? (uint32_t)d : 0;
+}
+
+/**
+ * @brief Executa os vencidos
+ */
+void temporizadorProcessa(void) {
+  if (!s_iniciada) return;
+
+  uint32_t agora = millis();
+  while ((int32_t)(agora - s_base) >= 0) {
+    uint8_t idx = s_base & (SLOTS - 1);
+
+    // Nível de baixo deu a volta: desce o compartimento atual de cada nível acima
+    if (idx == 0) {
+      for (uint8_t n = 1; n < NIVEIS; n++) {
+        uint8_t slot = (s_base >> (BITS_NIVEL * n)) & (SLOTS - 1);
+        cascata(n, slot);
+        if (slot != 0) break;
+      }
+    }
+
+    while (s_cabeca[0][idx] != VAZIO) {
+      uint8_t i = s_cabeca[0][idx];
+      Temporizador_Type &t = s_tmr[i];
+      desliga(i);
+      t.armado = false;
+      if (t.periodo) {                                          // periódico: rearma antes do callback
+        t.prazo += t.periodo;
+        if ((int32_t)(t.prazo - agora) <= 0) t.prazo = agora + t.periodo;   // atrasado: não acumula vencimentos
+        t.armado = true;
+        liga(i);
+      }
+      t.cb(t.arg);
+    }
+
+    // Pula os compartimentos vazios (sem passar do fim do nível nem de agora). Com
+    // o nível 0 todo vazio, pula também as voltas cujo compartimento do nível 1
+    // está vazio (cascata sem efeito). O compartimento de agora é revisto no
+    // próximo processamento: recebe o que for armado já vencido (a cascata
+    // repetida só religa no mesmo lugar).
+    uint32_t passo = proximoOcupado(0, idx + 1) - idx;
+    if (proximoOcupado(0, 0) == SLOTS) {
+      uint8_t j = (s_base >> BITS_NIVEL) & (SLOTS - 1);
+      passo += (uint32_t)(proximoOcupado(1, j + 1) - j - 1) << BITS_NIVEL;
+    }
+    uint32_t resta = agora - s_base;
+    if (resta == 0) break;
+    s_base += (passo < resta) ? passo : resta;
+  }
+}
+
+/**
+ * @brief Tempo até o próximo vencimento
+ */
+bool temporizadorProximo(uint32_t &espera) {
+  uint32_t agora = millis();
+  bool armado = false;
+  int32_t menor = 0;
+
+  for (uint8_t i = 0; i < TEMPORIZADOR_MAX; i++) {
+    if (!s_tmr[i].armado || !s_tmr[i].acorda) continue;
+    int32_t d = (int32_t)(s_tmr[i].prazo - agora);
+    if (!armado || (d < menor)) menor = d;
+    armado = true;
+  }
+  espera = (menor > 0) ? (uint32_t)menor : 0;
+  return armado;
+}
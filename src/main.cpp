@@ -27,12 +27,22 @@ Data:  26 de  Abril 2025
 #include "aplic.h"
 #include "config.h"
 #include "credentials.h"
+#if ENABLE_WATCHDOG
+#include <esp_task_wdt.h>
+#endif
 
 // Headers de Comunicação
 
 #include "CommunicationHandler.h"
 #include "LoRaHandler.h"
 #include "Logger.h"
+#include "PowerManager.h"
+#include "Payload.h"
+#include "Historico.h"
+#include "Agenda.h"
+#include "Temporizador.h"
+#include "Falhas.h"
+#include "Reconexao.h"
 
 //*****************************************************************************************
 //  DEFINIÇÕES GLOBAIS, CONSTANTES E VARIÁVEIS
@@ -51,30 +61,47 @@ LoRaConfig loraConfig = {
     .fixedDR = LORA_FIXED_DR,
     .joinTimeout = JOIN_TIMEOUT_VALUE,
     .confirmTimeout = CFM_TIMEOUT_VALUE,
-    .maxRetries = 3
+    .maxRetries = 3,
+    .linkPollInterval = LORA_LINK_POLL_INTERVAL,
+    .cfmPollInterval = CFM_POLL_INTERVAL
 };
 
 // Instância do handler de comunicação (pode ser trocada por WiFiHandler, etc)
 LoRaHandler* commHandler = nullptr;
 
 // Estrutura de Dados dos Sensores (Definida em Sensores.h/Aplic.h)
-CPendio_LoRa_Sensor_Data_Type CPendio_LoRa_Sensor_Data;
+CPendio_Amostra_Type CPendio_Amostra;                 // Leitura numérica
+CPendio_LoRa_Sensor_Data_Type CPendio_LoRa_Sensor_Data;  // Frame v01 (ASCII)
 
 // RAM variable to store the EEPROM Value stored in position 0
-uint8_t NVM_LoRaWAN_Cycle_Time = 0;                              
+RTC_DATA_ATTR uint8_t NVM_LoRaWAN_Cycle_Time = 0;                              
 
 // RAM variable to store the EEPROM Value stored in the LSbit of position 1
-bool NVM_LoRaWAN_Use_Cfm = false;       
+RTC_DATA_ATTR bool NVM_LoRaWAN_Use_Cfm = false;       
 
 // Variáveis de Controle de Tempo
-unsigned long timeout   = 0;
 unsigned long timenow   = 0;
-unsigned long timecycle = 0;
+RTC_DATA_ATTR unsigned long timecycle = 0;    // mantido no deep sleep
+
+// Temporizadores do loop (Temporizador.h)
+int8_t tmrCiclo         = -1;    // próximo passo da máquina de estados (timecycle)
+bool cicloVencido       = false;
+#if TILT_ALARM_ENABLED
+int8_t tmrAlarme        = -1;    // espera antes de reenviar o alarme de inclinação
+bool alarmeEspera       = false;
+bool alarmePreempta     = false;  // alarme pendente: encerra a espera do ACK no próximo passo
+uint16_t alarmeJoin     = 0;      // nós do alarme que já anteciparam um JOIN
+#endif
 
 // Variáveis de Controle LoRa
-bool joined     = false;
-int nack_count  = 0;              // Contador de não-confirmações (NACK)
-int err_count   = 0;              // Contador de exceções sequenciais
+// (RTC_DATA_ATTR: mantidas durante o deep sleep entre ciclos)
+RTC_DATA_ATTR bool joined     = false;
+volatile bool joinDone        = false;   // JOIN concluído (callback): antecipa o próximo passo
+volatile bool cfmDone         = false;   // espera do ACK concluída (callback): antecipa o próximo passo
+RTC_DATA_ATTR int nack_count  = 0;       // Contador de não-confirmações (NACK)
+RTC_DATA_ATTR bool joinPendente = false; // próximo passo em STATE_NOT_JOINED envia o JOIN (fim do recuo, Reconexao.h)
+RTC_DATA_ATTR uint32_t cfmInicio = 0;    // rtcMillis() do envio aceito (espera do ACK através do deep sleep)
+RTC_DATA_ATTR bool cfmDorme   = false;   // STATE_WAIT_CFM sem consulta pendente: pode dormir até o próximo passo
 
 // Variável de Estado do LED
 int LedState = LOW;
@@ -89,24 +116,25 @@ enum SystemState {
 };
 
 // Inicializa a variável de estado
-uint16_t State = STATE_NOT_JOINED; 
-
-/* Configurações de Erro e Retentativa -------------------------------------------*/
-constexpr int ERROR_RESTART   = 0; // Limpa erros (reinicia o contador)
-constexpr int ERROR_LORAWAN   = 1; // Erro de comunicação no LoRaWAN
-constexpr int RESTART_REQUEST = 2; // Solicitação remota de reinício (imediata)
-constexpr int ERROR_MAX_SEQ   = 5; // Máximo de erros antes do reset forçado
+RTC_DATA_ATTR uint16_t State = STATE_NOT_JOINED;   // mantido no deep sleep
 
 // ---------------------------------------------------------------------------
 // Protótipos - funções auxiliares (assinam com as implementações abaixo)
 // ---------------------------------------------------------------------------
 void ToggleLed(void);
-void exception_handling(int Exception_code);
+void onJoinComplete(bool connected);
+void onConfirmComplete(bool confirmed);
+void onCiclo(void *arg);
+void onEstatisticas(void *arg);
+#if ENABLE_WATCHDOG
+void onWatchdog(void *arg);
+#endif
+void onRecuperaLoRa(void *arg);
+#if TILT_ALARM_ENABLED
+void onAlarme(void *arg);
+#endif
 uint8_t Validate_Cycle_Time(uint8_t ct);
 
-// Ponteiro para a função de reset (software)
-void (*reset_function)(void) = 0;
-
 //*****************************************************************************************
 //  IMPLEMENTAÇÃO
 //*****************************************************************************************
@@ -122,42 +150,74 @@ void ToggleLed(void) {
 }
 
 /**
- * @brief Gerencia erros críticos e reinícios do sistema.
- * @param Exception_code Código do erro (ERROR_RESTART, ERROR_LORAWAN, etc).
+ * @brief Callback de conclusão do JOIN (chamado de dentro de process()).
+ * @param connected true se conectado à rede.
  */
-void exception_handling(int Exception_code) {
+void onJoinComplete(bool connected) {
 
-  switch (Exception_code) {
-    case ERROR_RESTART:
-      // Sucesso: Zera contador de erros
-      err_count = 0;
-      break;
+  joinDone = true;                                                                          // reavalia o estado sem esperar o timecycle
+  if (!connected) LOGW("COMM", "Join attempt failed");
 
-    case ERROR_LORAWAN:
-      // Processa um erro adicional LoRaWAN
-      LOGW("SYSTEM", "Error Code: %d", Exception_code);
-      err_count++;
-      // Caso o contador de erros exceder o limite de erros consecutivos, força reinício
-      if (err_count > ERROR_MAX_SEQ) {
-        LOGE("SYSTEM", "Forced Reset in 30s due to repeated LoRa errors");
-        delay(30000);
-        reset_function();
-      }
-      break;
+}
 
-    case RESTART_REQUEST:
-      LOGW("SYSTEM", "Immediate Reset Requested - rebooting in 30s");
-      delay(30000);
-      reset_function();
-      break;
+/**
+ * @brief Callback da confirmação do uplink (chamado de dentro de process()).
+ * @param confirmed true se o ACK chegou.
+ */
+void onConfirmComplete(bool confirmed) {
 
-    default:
-      LOGW("SYSTEM", "Undefined Exception - ignored (%d)", Exception_code);
-      break;
+  if (State == STATE_WAIT_CFM) cfmDone = true;                                              // fim da espera sem o CFM_TIMEOUT_VALUE (o alarme não antecipa o ciclo)
+  if (!confirmed) LOGW("COMM", "Confirmation wait timed out");
+
+}
 
+/**
+ * @brief Temporizador do ciclo: libera o próximo passo da máquina de estados.
+ */
+void onCiclo(void *arg) {
+  cicloVencido = true;
+}
+
+/**
+ * @brief Registra periodicamente a latência dos comandos AT.
+ */
+void onEstatisticas(void *arg) {
+  commHandler->logLatencyStats();
+}
+
+#if ENABLE_WATCHDOG
+/**
+ * @brief Alimenta o watchdog da task do loop (para se o loop travar).
+ */
+void onWatchdog(void *arg) {
+  esp_task_wdt_reset();
+}
+#endif
+
+/**
+ * @brief Recuperação do LoRa (Falhas.h): reset do módulo (ATZ), reconfiguração e novo JOIN.
+ */
+void onRecuperaLoRa(void *arg) {
+  LOGW("COMM", "Recovering LoRa module - reset and rejoin");
+  joinPendente = !commHandler->begin();
+  if (!joinPendente) {
+    commHandler->connect();                  // não bloqueia: o JOIN avança em process()
+  } else {
+    falhaRegistra(FALHA_LORA_MODULO);        // STATE_NOT_JOINED tenta de novo
   }
+  State = STATE_NOT_JOINED;
+  timecycle = JOIN_TIMEOUT_VALUE;
+  temporizadorArma(tmrCiclo, millis() + JOIN_TIMEOUT_VALUE);
+}
 
+#if TILT_ALARM_ENABLED
+/**
+ * @brief Fim da espera após uma falha no envio do alarme: o loop tenta de novo.
+ */
+void onAlarme(void *arg) {
+  alarmeEspera = false;
 }
+#endif
 
 /**
  * @brief Valida o tempo de ciclo lido da EEPROM.
@@ -212,6 +272,9 @@ uint8_t Validate_Settings(uint8_t st)
 void setup() {
   // 1. Inicialização do Hardware Básico
 
+  // Identifica a volta do deep sleep (estado RTC válido)
+  PowerManager::begin();
+
   // Configura os pinos (HW.cpp)
   iniHW();                                   
 
@@ -223,6 +286,18 @@ void setup() {
 
   // Inicializa logger (Serial)
   Logger::begin(115200);
+
+  // Causa do boot (reinício anterior) e contadores de falhas
+  iniFalhas();
+
+#if ENABLE_DEEP_SLEEP
+  // Acordou pelo pluviômetro: conta as básculas e volta a dormir pelo restante do ciclo
+  if (PowerManager::isGpioWake() && contaChuvaAcordar() && PowerManager::remainingSleep()) {
+    agendaChuva();                                                    // intensidade da chuva para o próximo ciclo
+    preparaSonoChuva();
+    PowerManager::deepSleep(PowerManager::remainingSleep());
+  }
+#endif
   
   // Comunicação UART para o módulo LoRa
   loraSerial.begin(9600, SERIAL_8N1, RXD1_LoRa, TXD1_LoRa);
@@ -244,47 +319,87 @@ void setup() {
     g_bBMPPresente = false;
   } else {
     LOGI("SENSOR", "BMP280 detectado");
-    // Configuração padrão de acordo com o datasheet
+    // Modo forçado: uma conversão por varredura, o sensor dorme entre ciclos.
+    // Sem filtro IIR: com amostras a minutos de distância ele só atrasaria a leitura.
     bmp.setSampling(
-      Adafruit_BMP280::MODE_NORMAL,     // Operating Mode. 
+      Adafruit_BMP280::MODE_FORCED,     // Operating Mode. 
       Adafruit_BMP280::SAMPLING_X2,     // Temp. oversampling 
       Adafruit_BMP280::SAMPLING_X16,    // Pressure oversampling 
-      Adafruit_BMP280::FILTER_X16,      // Filtering. 
-      Adafruit_BMP280::STANDBY_MS_500   // Standby time. 
+      Adafruit_BMP280::FILTER_OFF,      // Filtering. 
+      Adafruit_BMP280::STANDBY_MS_500   // Standby time (só no modo normal). 
     ); 
     g_bBMPPresente = true;
   }
 
-  // Delay para estabilização
-  delay(1000);
+  // Delay para estabilização (desnecessário ao acordar: a alimentação já está estável)
+  if (!PowerManager::isWarmBoot()) delay(1000);
 
   // 4. Mensagem de Boas-vindas
   LOGI("SYSTEM", "=== PENDIO SERVIDOR - INICIANDO ===");
   LOGI("SYSTEM", "Versão: %s", Versao);
   LOGI("SYSTEM", "Data: %s", Data);
+  if (PowerManager::isWarmBoot()) LOGI("SYSTEM", "Retomando do deep sleep (estado %u)", (unsigned)State);
   
   // Inicializa estruturas de dados dos sensores
-  iniSensores(CPendio_LoRa_Sensor_Data.d);
+  iniSensores();
 
   // 5. Configuração do Handler de Comunicação
   LOGI("COMM", "Inicializando handler de comunicação...");
-  LOGI("COMM", "Frame size: %u", (unsigned)sizeof(CPendio_LoRa_Sensor_Data));
+#if PAYLOAD_FRAME_FORMAT == 6
+  LOGI("COMM", "Frame format v06 (v02 + tilt window dispersion, %u bytes)", (unsigned)PAYLOAD_V06_SIZE);
+#elif PAYLOAD_FRAME_FORMAT == 5
+  LOGI("COMM", "Frame format v05 (up to %u SPendio nodes, %u bytes + %u bits per node)", (unsigned)SPENDIO_MAX,
+       (unsigned)PayloadSchema::bytesV05(0), (unsigned)(PayloadSchema::NoV05<0>::bits));
+#elif PAYLOAD_FRAME_FORMAT == 4
+  LOGI("COMM", "Frame format v04 (keyframe/delta, up to %u samples, keyframe every %u frames)",
+       (unsigned)historicoCapacidade(), (unsigned)DELTA_KEYFRAME_INTERVAL);
+#elif PAYLOAD_FRAME_FORMAT == 3
+  LOGI("COMM", "Frame format v03 (batch up to %u samples, %u bytes each)", (unsigned)historicoCapacidade(),
+       (unsigned)((PayloadSchema::LOTE_BITS_IDADE + PayloadSchema::AmostraV02::bits + 7) / 8));
+#elif PAYLOAD_FRAME_FORMAT == 2
+  LOGI("COMM", "Frame format v02, size: %u bytes", (unsigned)PAYLOAD_V02_SIZE);
+#else
+  LOGI("COMM", "Frame format v01, size: %u", (unsigned)sizeof(CPendio_LoRa_Sensor_Data));
+#endif
 
-  // Carrega informações da EEPROM
-  #ifdef USE_EEPROM
-    NVM_LoRaWAN_Cycle_Time = EEPROM.read(0);
-    NVM_LoRaWAN_Use_Cfm = (NVM_SETTINGS_CFM_BIT == (EEPROM.read(1) & NVM_SETTINGS_CFM_BIT));
-  #else
-    NVM_LoRaWAN_Cycle_Time = 0;
-    NVM_LoRaWAN_Use_Cfm = true;
-  #endif
-  NVM_LoRaWAN_Cycle_Time = Validate_Cycle_Time(NVM_LoRaWAN_Cycle_Time);
+  // Carrega informações da EEPROM (ao acordar, os valores estão na memória RTC)
+  if (!PowerManager::isWarmBoot()) {
+    #ifdef USE_EEPROM
+      NVM_LoRaWAN_Cycle_Time = EEPROM.read(0);
+      NVM_LoRaWAN_Use_Cfm = (NVM_SETTINGS_CFM_BIT == (EEPROM.read(1) & NVM_SETTINGS_CFM_BIT));
+    #else
+      NVM_LoRaWAN_Cycle_Time = 0;
+      NVM_LoRaWAN_Use_Cfm = true;
+    #endif
+    NVM_LoRaWAN_Cycle_Time = Validate_Cycle_Time(NVM_LoRaWAN_Cycle_Time);
+  }
 
   // Atualizar configuração com valores da EEPROM
   loraConfig.useConfirmation = NVM_LoRaWAN_Use_Cfm;
 
   // Criar instância do handler LoRa
   commHandler = new LoRaHandler(loraConfig);
+  commHandler->setConnectCallback(onJoinComplete);
+  commHandler->setConfirmCallback(onConfirmComplete);
+
+  // Temporizadores do loop: só o ciclo limita o deep sleep (os demais são recriados ao acordar)
+  tmrCiclo = temporizadorCria(onCiclo);
+  falhasRecuperacao(onRecuperaLoRa);
+#if TILT_ALARM_ENABLED
+  tmrAlarme = temporizadorCria(onAlarme, false);
+#endif
+  temporizadorArma(temporizadorCria(onEstatisticas, false), millis() + LORA_STATS_LOG_INTERVAL, LORA_STATS_LOG_INTERVAL);
+#if ENABLE_WATCHDOG
+  esp_task_wdt_init(WATCHDOG_TIMEOUT / 1000, true);
+  esp_task_wdt_add(NULL);
+  temporizadorArma(temporizadorCria(onWatchdog, false), millis(), WATCHDOG_TIMEOUT / 4);
+#endif
+
+  // Ao acordar, o módulo mantém a configuração e a sessão: basta retomar
+  if (PowerManager::isWarmBoot() && commHandler->resume()) {
+    temporizadorArma(tmrCiclo, millis());    // retoma a máquina de estados imediatamente
+    return;
+  }
 
   // Inicializar handler
   if (!commHandler->begin()) {
@@ -302,17 +417,27 @@ void setup() {
     }
     hexstr[32] = '\0';
     LOGI("COMM", "DevEUI: %s", hexstr);
+    iniReconexao(deveui, sizeof(deveui));  // jitter do recuo semeado pelo DevEUI
+  } else {
+    iniReconexao(nullptr, 0);
   }
 
-  // Inicia JOIN
+  // Inicia JOIN (após um reinício com JOINs sem sucesso, só depois do recuo)
   delay(500);
   ToggleLed();
-  LOGI("COMM", "Primeira tentativa de conexão à rede (JOIN)...");
-  commHandler->connect();
+  timecycle = reconexaoEspera();
+  joinPendente = (timecycle != 0);
+  if (joinPendente) {
+    LOGI("COMM", "JOIN adiado %lu s (recuo de %u tentativas)", (unsigned long)(timecycle / 1000), (unsigned)reconexaoTentativas());
+  } else {
+    LOGI("COMM", "Primeira tentativa de conexão à rede (JOIN)...");
+    commHandler->connect();                // não bloqueia: o JOIN avança em process()
+    timecycle = JOIN_TIMEOUT_VALUE;        // Timeout para o processo de Join
+  }
 
   // Define TIMERS iniciais
-  timeout = millis() + JOIN_TIMEOUT_VALUE; // Timeout para o processo de Join
-  timecycle = JOIN_TIMEOUT_VALUE;          // Timecycle para comparação posterior
+  temporizadorArma(tmrCiclo, millis() + timecycle);
+  State = STATE_NOT_JOINED;                // Estado RTC descartado (módulo reiniciado)
 
 }
 
@@ -345,9 +470,53 @@ void loop() {
   DownlinkMessage downlink;
   uint8_t port;
 
+  commHandler->process();  // advance the asynchronous operations (JOIN, timeouts)
+  temporizadorProcessa();  // due timers: state machine cycle, stats, watchdog
+
+#if TILT_ALARM_ENABLED
+  // Tilt alarm: sent right away on its own port, without waiting for the cycle, once the module is idle
+  Alarme_Inclinacao_Type alarme;
+  if (!alarmeEspera && inclinacaoAlarme(alarme)) {
+    if ((State == STATE_NOT_JOINED) && joinPendente && (alarme.mapa & ~alarmeJoin)) {
+      LOGW("COMM", "Tilt alarm pending - joining now");                                   // skip the backoff once per alarm
+      alarmeJoin |= alarme.mapa;
+      joinPendente = false;
+      commHandler->connect();
+      timecycle = JOIN_TIMEOUT_VALUE;
+      temporizadorArma(tmrCiclo, millis() + timecycle);
+    } else if ((State == STATE_WAIT_CFM) && NVM_LoRaWAN_Use_Cfm && !alarmePreempta && commHandler->rxWindowsDone()) {
+      alarmePreempta = true;                                                                // RX windows over: settle the ACK now, the alarm goes out from STATE_READY
+      cfmDone = true;
+    } else if ((State == STATE_READY) || ((State == STATE_WAIT_CFM) && !NVM_LoRaWAN_Use_Cfm && commHandler->rxWindowsDone())) {
+      uint8_t frame[PayloadSchema::bytesAlarme(SPENDIO_MAX)];
+      char frameHex[2 * sizeof(frame) + 1];                                                 // AT+SENDX: ASCII hexa
+      payloadHex(frame, montaPayloadAlarme(alarme, frame), frameHex);
+      SendResult envio = commHandler->send(TILT_ALARM_PORT, (const uint8_t*)frameHex, strlen(frameHex));
+      if (envio == SendResult::SUCCESS) {
+        inclinacaoAlarmeEnviado(alarme.mapa);
+        alarmeJoin &= ~alarme.mapa;
+        agendaUplink(commHandler->getAirtime(strlen(frameHex) / 2));                          // counts against the airtime budget (never held back)
+        LOGW("COMM", "Tilt alarm sent (port=%d, nodes=0x%04X)", TILT_ALARM_PORT, (unsigned)alarme.mapa);
+#if PAYLOAD_FRAME_FORMAT == 4
+        payloadDeltaPerdido();                                                              // alarm took an FCnt: the server would see a gap, next frame is a keyframe
+#endif
+        if (temporizadorRestante(tmrCiclo) < TILT_ALARM_GUARD) temporizadorArma(tmrCiclo, millis() + TILT_ALARM_GUARD);   // module busy with TX/RX windows
+      } else {
+        alarmeEspera = true;                                                                // alarm stays pending: retry after TILT_ALARM_RETRY, not every loop
+        temporizadorArma(tmrAlarme, millis() + TILT_ALARM_RETRY);
+        if (envio != SendResult::PENDING) {
+          LOGE("COMM", "Tilt alarm send failed - retry in %u s", (unsigned)(TILT_ALARM_RETRY / 1000));
+          falhaRegistra(FALHA_LORA_TX);
+        }
+      }
+    }
+  }
+#endif
+
   timenow = millis();     // sample running time only here for all uses (including future calculations)
-  if(((unsigned long)(timeout - timenow))>((unsigned long)(-timecycle)))                    // compare if time has come, but also during passage through zero (each ~49..50 days)
+  if(joinDone || cfmDone || cicloVencido)                                                   // cycle timer expired (wraparound handled by the timer wheel), JOIN or ACK wait finished
   {
+    cicloVencido = false;
     switch(State)
     {
       case STATE_NOT_JOINED:          // IF NOT JOINED YET...
@@ -358,11 +527,20 @@ void loop() {
 #endif
           if(!joined){ LOGI("COMM", "Joined network"); joined = true; }                        // print the "joined" message & set first message after Join to be sent
           State = STATE_READY;
-        } else {
+          joinPendente = false;
+          reconexaoOk();                                                                    // backoff restarts from JOIN_BACKOFF_MIN
+          timecycle = JOIN_TIMEOUT_VALUE;                                                   // wait the shortest time to start something
+        } else if(commHandler->getConnectionState() == ConnectionState::CONNECTING) {       // JOIN in progress (joinDone ends the wait early)
+          timecycle = JOIN_TIMEOUT_VALUE;
+        } else if(joinPendente) {                                                           // backoff elapsed
           LOGI("COMM", "Another attempt to Join the network");
+          joinPendente = false;
           commHandler->connect();
+          timecycle = JOIN_TIMEOUT_VALUE;
+        } else {                                                                            // JOIN failed (or link lost): exponential backoff with jitter
+          joinPendente = true;
+          timecycle = reconexaoFalhou();
         }
-        timecycle = JOIN_TIMEOUT_VALUE;                                                     // Joined or not, wait the shortest time to start something
       break;
       case STATE_READY:               // IF ALREADY JOINED OR TX + RX COMPLETE...
         // Process Data Generation Functions (sensors read) = Here
@@ -382,22 +560,87 @@ void loop() {
         }
         data[2*x] = 0;
 */
-        varrSensores(CPendio_LoRa_Sensor_Data.d);     // Varre Sensores
+        agendaInicioCiclo();                          // next scan: one (rain-adapted) cycle from here
+        varrSensores(CPendio_Amostra);                // Varre Sensores
         nack_count = 0;
 
         // Enviar dados através do handler de comunicação
         {
-          LOGD("COMM", "Data payload (len=%u)", (unsigned)sizeof(CPendio_LoRa_Sensor_Data));
+#if PAYLOAD_FRAME_FORMAT == 6
+          uint8_t frame[PAYLOAD_V06_SIZE];
+          char frameHex[2 * PAYLOAD_V06_SIZE + 1];                                          // AT+SENDX: ASCII hexa
+          payloadHex(frame, montaPayloadV06(CPendio_Amostra, frame), frameHex);
+          const char* payload = frameHex;
+#elif PAYLOAD_FRAME_FORMAT == 5
+          // Nós registrados que couberem no data rate atual (rodízio dos demais)
+          uint8_t frame[LORA_MAX_PAYLOAD];
+          char frameHex[2 * LORA_MAX_PAYLOAD + 1];                                          // AT+SENDX: ASCII hexa
+          payloadHex(frame, montaPayloadV05(CPendio_Amostra, registroSPendio(), commHandler->getMaxPayload(), frame),
+                     frameHex);
+          const char* payload = frameHex;
+#elif PAYLOAD_FRAME_FORMAT == 4
+          historicoAdiciona(CPendio_Amostra, PowerManager::rtcSegundos());
+
+          // Amostras até encher o payload do data rate atual (limitado por LORA_MAX_PAYLOAD)
+          uint8_t frame[LORA_MAX_PAYLOAD];
+          uint8_t porFrame;
+          uint8_t frameLen = montaPayloadDelta(commHandler->getMaxPayload(), PowerManager::rtcSegundos(),
+                                               frame, porFrame);
+          if (frameLen == 0) {
+            LOGI("COMM", "Sample stored (%u/%u)", (unsigned)historicoQuant(), (unsigned)historicoCapacidade());
+            timecycle = agendaEspera(NVM_LoRaWAN_Cycle_Time);                                 // next sample
+            break;
+          }
+
+          char frameHex[2 * LORA_MAX_PAYLOAD + 1];                                          // AT+SENDX: ASCII hexa
+          payloadHex(frame, frameLen, frameHex);
+          const char* payload = frameHex;
+#elif PAYLOAD_FRAME_FORMAT == 3
+          historicoAdiciona(CPendio_Amostra, PowerManager::rtcSegundos());
+
+          // Amostras por uplink no data rate atual (limitado pela fila e por LORA_MAX_PAYLOAD)
+          uint8_t maxPayload = commHandler->getMaxPayload();
+          uint8_t porFrame = amostrasPorFrame((maxPayload < LORA_MAX_PAYLOAD) ? maxPayload : LORA_MAX_PAYLOAD);
+          if (porFrame > historicoCapacidade()) porFrame = historicoCapacidade();
+          if (historicoQuant() < porFrame) {
+            LOGI("COMM", "Sample stored (%u/%u)", (unsigned)historicoQuant(), (unsigned)porFrame);
+            timecycle = agendaEspera(NVM_LoRaWAN_Cycle_Time);                                 // next sample
+            break;
+          }
+
+          uint8_t frame[LORA_MAX_PAYLOAD];
+          char frameHex[2 * LORA_MAX_PAYLOAD + 1];                                          // AT+SENDX: ASCII hexa
+          payloadHex(frame, montaPayloadLote(porFrame, PowerManager::rtcSegundos(), frame), frameHex);
+          const char* payload = frameHex;
+#elif PAYLOAD_FRAME_FORMAT == 2
+          uint8_t frame[PAYLOAD_V02_SIZE];
+          char frameHex[2 * PAYLOAD_V02_SIZE + 1];                                          // AT+SENDX: ASCII hexa
+          payloadHex(frame, montaPayloadV02(CPendio_Amostra, frame), frameHex);
+          const char* payload = frameHex;
+#else
+          montaPayloadV01(CPendio_Amostra, CPendio_LoRa_Sensor_Data.d);
+          const char* payload = CPendio_LoRa_Sensor_Data.Bytes;
+#endif
+          uint16_t payloadLen = strlen(payload);
+          LOGD("COMM", "Data payload (len=%u): %s", (unsigned)payloadLen, payload);
 
-          SendResult sendResult = commHandler->send(1, (const uint8_t*)CPendio_LoRa_Sensor_Data.Bytes,
-                                                    sizeof(CPendio_LoRa_Sensor_Data));
+          SendResult sendResult = commHandler->send(1, (const uint8_t*)payload, payloadLen);
 
           if(sendResult == SendResult::SUCCESS) {
             State = STATE_WAIT_CFM;                                                           // Aguarda confirmação
-            timecycle = CFM_TIMEOUT_VALUE;                                                    // After a message has been accepted, wait for some time.
+            timecycle = CFM_POLL_WINDOW;                                                      // After a message has been accepted, poll the ACK awake for a short time (RX windows)
+            cfmInicio = PowerManager::rtcMillis();
+            cfmDorme = false;
             timenow = millis();                                                               // for TX resample running time
-            LOGI("COMM", "Tx accepted (port=%d, len=%u)", 1, (unsigned)sizeof(CPendio_LoRa_Sensor_Data));
-            exception_handling(ERROR_RESTART);                                                // Clear Error counter
+            LOGI("COMM", "Tx accepted (port=%d, len=%u)", 1, (unsigned)payloadLen);
+            agendaUplink(commHandler->getAirtime(payloadLen / 2));                            // AT+SENDX: 2 hex chars per byte
+            bateriaInicioTX();                                                                // battery sag while the radio is on
+#if PAYLOAD_FRAME_FORMAT == 4
+            payloadDeltaAceito(porFrame);                                                     // samples handed to the module, new delta reference
+#elif PAYLOAD_FRAME_FORMAT == 3
+            historicoDescarta(porFrame);                                                      // samples handed to the module
+#endif
+            falhasLimpa();                                                                    // Clear Error counter
           }
           else if(sendResult == SendResult::PENDING) {
             // Envio ainda pendente, manter estado
@@ -405,21 +648,46 @@ void loop() {
           }
           else {
             State = STATE_NOT_JOINED;                                                         // This should not happen... Go back to start
+            joinPendente = true;                                                              // rejoin on the next step
             timecycle = JOIN_TIMEOUT_VALUE;
             LOGE("COMM", "Tx denied - restarting join");
-            exception_handling(ERROR_LORAWAN);
+#if PAYLOAD_FRAME_FORMAT == 4
+            payloadDeltaPerdido();                                                            // FCnt restarts: next frame is a keyframe
+#endif
+            falhaRegistra(FALHA_LORA_TX);
           }
         }
       break;
       case STATE_WAIT_CFM:                                                                  // After TX gets here to check what else to do
+        {
+          uint16_t queda = bateriaFimTX();
+          if (queda) LOGI("SENSOR", "VBAT sag during TX: %u mV", (unsigned)queda);
+        }
         if(true == NVM_LoRaWAN_Use_Cfm) {                                                   // If confirmation was expected...
-          if (commHandler->isConfirmed()) {                                                 // ...and message has been confirmed...
+          bool ack = commHandler->isConfirmed();
+          uint32_t decorrido = PowerManager::rtcMillis() - cfmInicio;
+#if TILT_ALARM_ENABLED
+          bool preempta = alarmePreempta;
+          alarmePreempta = false;
+#else
+          bool preempta = false;
+#endif
+          if (!ack && !preempta && (decorrido < CFM_TIMEOUT_VALUE)) {
+            timecycle = CFM_TIMEOUT_VALUE - decorrido;                                      // RX windows over: idle (deep sleep) until the ACK timeout, then check once more
+            cfmDorme = true;
+            LOGD("COMM", "No acknowledgement yet - next check in %lu s", (unsigned long)(timecycle / 1000));
+            break;
+          }
+          if (ack) {                                                                        // ...and message has been confirmed...
             LOGI("COMM", "Acknowledgement received");
-            exception_handling(ERROR_RESTART);                                              // Clear Error counter
+            falhasLimpa();                                                                  // Clear Error counter
           }
           else {
             LOGW("COMM", "No acknowledgement received");
-            exception_handling(ERROR_LORAWAN);                                              // Otherwise report error
+#if PAYLOAD_FRAME_FORMAT == 4
+            payloadDeltaPerdido();                                                          // Frame may be lost: next one is a keyframe
+#endif
+            falhaRegistra(FALHA_LORA_CFM);                                                  // Otherwise report error
           }
           
           // Tentar ler mensagem downlink
@@ -436,7 +704,17 @@ void loop() {
                   LOGI("COMM", "New Cycle Time: %u", (unsigned)NVM_LoRaWAN_Cycle_Time);
                 }
                 if ((downlink.data[1] == '2') && (downlink.data[2]==0x0)) {                // 0x82 - Restart Request
-                  exception_handling(RESTART_REQUEST); 
+                  falhasReinicia(REINICIO_PEDIDO, FAULT_RESTART_DELAY);                       // clean esp_restart after this step
+                }
+                if ((downlink.data[1] == '6') && (downlink.data[4]==0x0)) {                // 0x86 0x00 - Keyframe request (server lost the delta reference)
+#if PAYLOAD_FRAME_FORMAT == 4
+                  payloadDeltaPerdido();
+                  LOGI("COMM", "Keyframe requested");
+#endif
+                }
+                if ((downlink.data[1] == '8') && (downlink.data[4]==0x0)) {                // 0x88 0x00 - New tilt baseline
+                  inclinacaoNovaBase();
+                  LOGI("COMM", "New tilt baseline requested");
                 }
                 if ((downlink.data[1] == '4') && (downlink.data[4]==0x0)) {                // 0x84 0xNN - Confirmation required?
                   NVM_LoRaWAN_Use_Cfm = (NVM_SETTINGS_CFM_BIT == ((downlink.data[3]-'0') & NVM_SETTINGS_CFM_BIT));
@@ -450,24 +728,38 @@ void loop() {
           }
           
           State = STATE_READY;                                                              // Go back to restart the whole process
-          timecycle = 20000;                                                                // CCS - Hardcoded 20s
+          timecycle = agendaEspera(NVM_LoRaWAN_Cycle_Time);                                 // rest of the cycle (rain-adapted, airtime budget)
         } else {
           timecycle = NEXT_MSG_TIMEOUT_VALUE;                                               // ...next message in a shorter time
+          cfmDorme = true;
           LOGW("COMM", "No Ack - will retry");
           nack_count++;
           if (nack_count++ > LORA_MAX_NACK_RETRIES) {
             nack_count = 0;
             State = STATE_READY;                                                            // Go back to restart the whole process
-            exception_handling(ERROR_LORAWAN);
+            falhaRegistra(FALHA_LORA_CFM);
           }
         }
       break;
       default:
         State = STATE_NOT_JOINED;
+        joinPendente = true;
         timecycle = JOIN_TIMEOUT_VALUE;                                                     // Joined or not, wait the shortest time to start something
-        exception_handling(ERROR_LORAWAN);
+        falhaRegistra(FALHA_ESTADO);
       break;
     }
-    timeout = timenow + timecycle;                                                          // update the timeout using timenow (since the start of processing) and timecycle
+    joinDone = false;                                                                       // JOIN result (if any) handled above
+    cfmDone = false;                                                                        // ACK result (if any) handled above
+    temporizadorArma(tmrCiclo, timenow + timecycle);                                        // next step: timecycle after timenow (since the start of processing)
+
+#if ENABLE_DEEP_SLEEP
+    // Long idle wait with no JOIN pending (or a JOIN backoff) and no ACK poll pending: sleep until the earliest deadline (state kept in RTC memory)
+    uint32_t espera;
+    bool ocioso = (State == STATE_READY) || ((State == STATE_NOT_JOINED) && joinPendente) || ((State == STATE_WAIT_CFM) && cfmDorme);
+    if (ocioso && temporizadorProximo(espera) && (espera >= DEEP_SLEEP_MIN_INTERVAL)) {
+      preparaSonoChuva();                                                                   // rain gauge keeps counting (ULP) or wakes the ESP32 (EXT0)
+      PowerManager::deepSleep(espera);
+    }
+#endif
   }
 }
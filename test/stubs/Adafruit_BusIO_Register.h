@@ -0,0 +1,12 @@
+/**
+ * @file Adafruit_BusIO_Register.h
+ * @brief Substituto do Adafruit BusIO para os testes no host (só os dispositivos)
+ */
+
+#ifndef _ADAFRUIT_BUSIO_REGISTER_STUB_H
+#define _ADAFRUIT_BUSIO_REGISTER_STUB_H
+
+#include "Adafruit_I2CDevice.h"
+#include "Adafruit_SPIDevice.h"
+
+#endif /* _ADAFRUIT_BUSIO_REGISTER_STUB_H */
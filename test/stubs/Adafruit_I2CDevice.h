@@ -0,0 +1,63 @@
+/**
+ * @file Adafruit_I2CDevice.h
+ * @brief Barramento I2C falso para os testes no host (substitui o Adafruit BusIO)
+ * @details Cada endereço é um dispositivo com 256 registradores: write()
+ *          grava a partir do primeiro byte (registrador), write_then_read()
+ *          lê a partir dele (BMP280). read() sem registrador devolve a
+ *          leitura programada em `leitura` (AHT20: estado + 5 bytes).
+ */
+
+#ifndef _ADAFRUIT_I2CDEVICE_STUB_H
+#define _ADAFRUIT_I2CDEVICE_STUB_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+struct FakeI2C_Dispositivo {
+  bool presente;
+  uint8_t reg[256];
+  uint8_t leitura[8];
+};
+
+inline FakeI2C_Dispositivo &fakeI2C(uint8_t endereco) {
+  static FakeI2C_Dispositivo d[128];
+  return d[endereco & 0x7F];
+}
+
+class Adafruit_I2CDevice {
+  public:
+    Adafruit_I2CDevice(uint8_t addr, TwoWire *theWire = &Wire) : _addr(addr) { (void)theWire; }
+    uint8_t address(void) { return _addr; }
+    bool begin(bool addr_detect = true) { (void)addr_detect; return detected(); }
+    bool detected(void) { return fakeI2C(_addr).presente; }
+
+    bool read(uint8_t *buffer, size_t len, bool stop = true) {
+      (void)stop;
+      FakeI2C_Dispositivo &d = fakeI2C(_addr);
+      if (!d.presente || len > sizeof(d.leitura)) return false;
+      memcpy(buffer, d.leitura, len);
+      return true;
+    }
+
+    bool write(const uint8_t *buffer, size_t len, bool stop = true,
+               const uint8_t *prefix_buffer = nullptr, size_t prefix_len = 0) {
+      (void)stop; (void)prefix_buffer; (void)prefix_len;
+      FakeI2C_Dispositivo &d = fakeI2C(_addr);
+      for (size_t i = 1; i < len; i++) d.reg[(uint8_t)(buffer[0] + i - 1)] = buffer[i];
+      return d.presente;
+    }
+
+    bool write_then_read(const uint8_t *write_buffer, size_t write_len, uint8_t *read_buffer,
+                         size_t read_len, bool stop = false) {
+      (void)write_len; (void)stop;
+      FakeI2C_Dispositivo &d = fakeI2C(_addr);
+      uint8_t r = write_buffer[0];          // o driver reaproveita o mesmo buffer
+      for (size_t i = 0; i < read_len; i++) read_buffer[i] = d.reg[(uint8_t)(r + i)];
+      return d.presente;
+    }
+
+  private:
+    uint8_t _addr;
+};
+
+#endif /* _ADAFRUIT_I2CDEVICE_STUB_H */
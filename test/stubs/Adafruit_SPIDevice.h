@@ -0,0 +1,38 @@
+/**
+ * @file Adafruit_SPIDevice.h
+ * @brief Substituto do Adafruit BusIO SPI para os testes no host (sem dispositivo)
+ */
+
+#ifndef _ADAFRUIT_SPIDEVICE_STUB_H
+#define _ADAFRUIT_SPIDEVICE_STUB_H
+
+#include "Arduino.h"
+
+enum { SPI_MODE0, SPI_MODE1, SPI_MODE2, SPI_MODE3 };
+
+typedef enum _BitOrder {
+  SPI_BITORDER_MSBFIRST,
+  SPI_BITORDER_LSBFIRST,
+} BusIOBitOrder;
+
+class SPIClass {};
+
+static SPIClass SPI;
+
+class Adafruit_SPIDevice {
+  public:
+    Adafruit_SPIDevice(int8_t cspin, uint32_t freq = 1000000, BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST,
+                       uint8_t dataMode = SPI_MODE0, SPIClass *theSPI = &SPI) {
+      (void)cspin; (void)freq; (void)dataOrder; (void)dataMode; (void)theSPI;
+    }
+    Adafruit_SPIDevice(int8_t cspin, int8_t sck, int8_t miso, int8_t mosi, uint32_t freq = 1000000,
+                       BusIOBitOrder dataOrder = SPI_BITORDER_MSBFIRST, uint8_t dataMode = SPI_MODE0) {
+      (void)cspin; (void)sck; (void)miso; (void)mosi; (void)freq; (void)dataOrder; (void)dataMode;
+    }
+    bool begin(void) { return false; }
+    bool write(const uint8_t *, size_t, const uint8_t * = nullptr, size_t = 0) { return false; }
+    bool write_then_read(const uint8_t *, size_t, uint8_t *, size_t, uint8_t = 0xFF) { return false; }
+    uint8_t transfer(uint8_t) { return 0xFF; }
+};
+
+#endif /* _ADAFRUIT_SPIDEVICE_STUB_H */
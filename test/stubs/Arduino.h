@@ -0,0 +1,67 @@
+/**
+ * @file Arduino.h
+ * @brief Substituto mínimo do núcleo Arduino/ESP32 para os testes no host (env:native)
+ * @details millis() é um relógio falso de 32 bits, avançado pelo teste
+ *          (fakeMillis() e delay()). Cada suíte é uma unidade de compilação
+ *          só (inclui os .cpp testados), então as definições ficam aqui.
+ */
+
+#ifndef _ARDUINO_STUB_H
+#define _ARDUINO_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+
+typedef uint8_t byte;
+
+#define HIGH              1
+#define LOW               0
+#define HEX               16
+#define DEC               10
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+
+// Relógio falso [ms]: 32 bits como no ESP32 (passa por zero em ~49,7 dias)
+inline uint32_t &fakeMillis(void) {
+  static uint32_t t = 0;
+  return t;
+}
+
+inline uint32_t millis(void) { return fakeMillis(); }
+inline uint32_t micros(void) { return fakeMillis() * 1000UL; }
+inline void delay(uint32_t ms) { fakeMillis() += ms; }
+inline void yield(void) {}
+
+// Serial: descarta a saída
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) { return 1; }
+    size_t print(const char *) { return 0; }
+    size_t print(char) { return 0; }
+    size_t print(int, int = DEC) { return 0; }
+    size_t print(unsigned, int = DEC) { return 0; }
+    size_t print(long, int = DEC) { return 0; }
+    size_t print(unsigned long, int = DEC) { return 0; }
+    size_t println(void) { return 0; }
+    size_t println(const char *) { return 0; }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available(void) { return 0; }
+    virtual int read(void) { return -1; }
+    virtual int peek(void) { return -1; }
+    void flush(void) {}
+};
+
+static Stream Serial;
+
+#endif /* _ARDUINO_STUB_H */
@@ -0,0 +1,42 @@
+/**
+ * @file LoggerHost.h
+ * @brief Logger dos testes no host: mesmas macros de include/Logger.h, imprime no stdout
+ * @details Incluído pelo teste antes do módulo testado: a mesma guarda
+ *          (LOGGER_H) descarta o Logger do firmware, que depende da Serial.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdarg.h>
+#include "Arduino.h"
+
+enum LogLevel {
+  LOG_LEVEL_DEBUG = 0,
+  LOG_LEVEL_INFO,
+  LOG_LEVEL_WARN,
+  LOG_LEVEL_ERROR,
+};
+
+// Nível mínimo impresso (os testes silenciam com LOG_LEVEL_ERROR + 1)
+inline int &loggerNivel(void) {
+  static int nivel = LOG_LEVEL_WARN;
+  return nivel;
+}
+
+inline void loggerImprime(int lvl, const char *tag, const char *fmt, ...) {
+  if (lvl < loggerNivel()) return;
+  va_list ap;
+  va_start(ap, fmt);
+  printf("[%s] ", tag);
+  vprintf(fmt, ap);
+  printf("\n");
+  va_end(ap);
+}
+
+#define LOGD(tag, ...) loggerImprime(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define LOGI(tag, ...) loggerImprime(LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define LOGW(tag, ...) loggerImprime(LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define LOGE(tag, ...) loggerImprime(LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -0,0 +1,6 @@
+/**
+ * @file Stream.h
+ * @brief Stream do substituto do núcleo Arduino (testes no host)
+ */
+
+#include "Arduino.h"
@@ -0,0 +1,15 @@
+/**
+ * @file Wire.h
+ * @brief Substituto do TwoWire para os testes no host: o barramento é o de Adafruit_I2CDevice.h
+ */
+
+#ifndef _WIRE_STUB_H
+#define _WIRE_STUB_H
+
+#include "Arduino.h"
+
+class TwoWire {};
+
+static TwoWire Wire;
+
+#endif /* _WIRE_STUB_H */
@@ -0,0 +1,43 @@
+/**
+ * @file esp_system.h
+ * @brief Substituto do esp_system.h (ESP-IDF) para os testes no host
+ * @details A causa do reset é definida pelo teste (fakeResetReason()) e o
+ *          esp_restart() só conta as chamadas (fakeRestarts()): o teste
+ *          simula o boot seguinte. esp_random() é o rand() da libc.
+ */
+
+#ifndef _ESP_SYSTEM_STUB_H
+#define _ESP_SYSTEM_STUB_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef enum {
+  ESP_RST_UNKNOWN,
+  ESP_RST_POWERON,
+  ESP_RST_EXT,
+  ESP_RST_SW,
+  ESP_RST_PANIC,
+  ESP_RST_INT_WDT,
+  ESP_RST_TASK_WDT,
+  ESP_RST_WDT,
+  ESP_RST_DEEPSLEEP,
+  ESP_RST_BROWNOUT,
+  ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+inline esp_reset_reason_t &fakeResetReason(void) {
+  static esp_reset_reason_t r = ESP_RST_POWERON;
+  return r;
+}
+
+inline uint32_t &fakeRestarts(void) {
+  static uint32_t n = 0;
+  return n;
+}
+
+inline esp_reset_reason_t esp_reset_reason(void) { return fakeResetReason(); }
+inline void esp_restart(void) { fakeRestarts()++; }
+inline uint32_t esp_random(void) { return (uint32_t)rand(); }
+
+#endif /* _ESP_SYSTEM_STUB_H */
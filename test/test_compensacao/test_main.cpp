@@ -0,0 +1,229 @@
+/**
+ * @file test_main.cpp
+ * @brief Compensação inteira do BMP280 e do AHT20: vetores de referência e benchmark
+ * @details As bibliotecas rodam sobre o barramento I2C falso de test/stubs.
+ *          BMP280: exemplo da folha de dados (BST-BMP280-DS001, seção 3.11.3)
+ *          e varredura de -40 a 85 °C e 300 a 1100 hPa contra a compensação
+ *          de 64 bits da própria biblioteca (readAll). A fórmula de 32 bits
+ *          da folha de dados fica entre -2 e +7 Pa dela (tendência positiva,
+ *          pelos truncamentos), abaixo da precisão relativa do sensor (±12 Pa).
+ *          AHT20: as 2^20 leituras brutas de umidade e de temperatura contra
+ *          a fórmula da folha de dados.
+ *          O benchmark mede o tempo no host (informativo, não reprova): o
+ *          x86 tem divisão de 64 bits e FPU de dupla precisão, que o ESP32
+ *          faz por software, então o ganho no alvo não aparece aqui.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include "../../lib/Adafruit_BMP280_Library/Adafruit_BMP280.cpp"
+#include "../../lib/Adafruit_AHTX0/Adafruit_AHTX0.cpp"
+
+// Calibração do exemplo da folha de dados do BMP280
+static const uint16_t DIG_T1 = 27504;
+static const int16_t  DIG_T2 = 26435, DIG_T3 = -1000;
+static const uint16_t DIG_P1 = 36477;
+static const int16_t  DIG_P2 = -10685, DIG_P3 = 3024, DIG_P4 = 2855, DIG_P5 = 140,
+                      DIG_P6 = -7, DIG_P7 = 15500, DIG_P8 = -14600, DIG_P9 = 6000;
+
+static Adafruit_BMP280 *s_bmp;
+static Adafruit_AHTX0 *s_aht;
+
+static void grava16(uint8_t *reg, uint16_t v) {
+  reg[0] = (uint8_t)v;                    // little endian
+  reg[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * @brief Leitura bruta do BMP280 (registradores 0xF7-0xFC, 20 bits alinhados à esquerda)
+ */
+static void bmpBruto(int32_t adcT, int32_t adcP) {
+  uint8_t *r = fakeI2C(BMP280_ADDRESS).reg;
+  r[0xF7] = (uint8_t)(adcP >> 12);
+  r[0xF8] = (uint8_t)(adcP >> 4);
+  r[0xF9] = (uint8_t)(adcP << 4);
+  r[0xFA] = (uint8_t)(adcT >> 12);
+  r[0xFB] = (uint8_t)(adcT >> 4);
+  r[0xFC] = (uint8_t)(adcT << 4);
+}
+
+/**
+ * @brief Leitura bruta do AHT20: estado + 20 bits de umidade + 20 bits de temperatura
+ */
+static void ahtBruto(uint32_t h, uint32_t t) {
+  uint8_t *d = fakeI2C(AHTX0_I2CADDR_DEFAULT).leitura;
+  d[0] = AHTX0_STATUS_CALIBRATED;
+  d[1] = (uint8_t)(h >> 12);
+  d[2] = (uint8_t)(h >> 4);
+  d[3] = (uint8_t)((h << 4) | (t >> 16));
+  d[4] = (uint8_t)(t >> 8);
+  d[5] = (uint8_t)t;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_bmp_inicia(void) {
+  FakeI2C_Dispositivo &d = fakeI2C(BMP280_ADDRESS);
+  d.presente = true;
+  d.reg[BMP280_REGISTER_CHIPID] = BMP280_CHIPID;
+  const uint16_t dig[] = { DIG_T1, (uint16_t)DIG_T2, (uint16_t)DIG_T3, DIG_P1, (uint16_t)DIG_P2, (uint16_t)DIG_P3,
+                           (uint16_t)DIG_P4, (uint16_t)DIG_P5, (uint16_t)DIG_P6, (uint16_t)DIG_P7,
+                           (uint16_t)DIG_P8, (uint16_t)DIG_P9 };
+  for (uint8_t i = 0; i < sizeof(dig) / sizeof(dig[0]); i++) grava16(&d.reg[BMP280_REGISTER_DIG_T1 + 2 * i], dig[i]);
+
+  s_bmp = new Adafruit_BMP280();
+  TEST_ASSERT_TRUE(s_bmp->begin());
+  s_bmp->setSampling(Adafruit_BMP280::MODE_FORCED);      // como em main.cpp
+  TEST_ASSERT_TRUE(s_bmp->startForcedMeasurement());
+}
+
+void test_bmp_vetor_da_folha_de_dados(void) {
+  int32_t t;
+  uint32_t p;
+  float tf, pf;
+
+  // adc_T = 519888, adc_P = 415148: T = 25,08 °C, p = 100653,27 Pa (64 bits);
+  // a fórmula de 32 bits dá 100656 Pa
+  bmpBruto(519888, 415148);
+  TEST_ASSERT_TRUE(s_bmp->readAllInt(&t, &p));
+  TEST_ASSERT_EQUAL_INT32(2508, t);
+  TEST_ASSERT_EQUAL_UINT32(100656, p);
+
+  TEST_ASSERT_TRUE(s_bmp->readAll(&tf, &pf));
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.08f, tf);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 100653.27f, pf);
+}
+
+void test_bmp_varredura_erro_menor_que_7pa(void) {
+  int32_t t;
+  uint32_t p;
+  float tf, pf;
+  float acima = 0, abaixo = 0;
+  uint32_t pontos = 0;
+
+  for (int32_t adcT = 380000; adcT <= 660000; adcT += 997) {
+    for (int32_t adcP = 150000; adcP <= 700000; adcP += 101) {
+      bmpBruto(adcT, adcP);
+      TEST_ASSERT_TRUE(s_bmp->readAll(&tf, &pf));
+      if (tf < -40 || tf > 85 || pf < 30000 || pf > 110000) continue;   // faixa de operação
+
+      TEST_ASSERT_TRUE(s_bmp->readAllInt(&t, &p));
+      TEST_ASSERT_INT_WITHIN(1, (int32_t)lroundf(tf * 100), t);
+      float erro = (float)p - pf;
+      if (erro > acima) acima = erro;
+      if (erro < abaixo) abaixo = erro;
+      pontos++;
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(100000, pontos);
+  TEST_ASSERT_TRUE_MESSAGE(acima <= 7.0f && abaixo >= -2.0f, "erro da compensação de 32 bits fora de -2..+7 Pa");
+
+  char msg[80];
+  snprintf(msg, sizeof(msg), "BMP280: %lu pontos, erro de %.2f a %.2f Pa", (unsigned long)pontos, abaixo, acima);
+  TEST_MESSAGE(msg);
+}
+
+void test_aht_inicia(void) {
+  fakeI2C(AHTX0_I2CADDR_DEFAULT).presente = true;
+  ahtBruto(0, 0);
+  s_aht = new Adafruit_AHTX0();
+  TEST_ASSERT_TRUE(s_aht->begin());
+  TEST_ASSERT_TRUE(s_aht->startMeasurement());
+}
+
+void test_aht_extremos(void) {
+  int32_t t;
+  uint16_t h;
+
+  ahtBruto(0, 0);
+  TEST_ASSERT_TRUE(s_aht->readMeasurementInt(&t, &h));
+  TEST_ASSERT_EQUAL_INT32(-5000, t);                      // -50,00 °C
+  TEST_ASSERT_EQUAL_UINT16(0, h);
+
+  ahtBruto(0x80000, 0x80000);
+  TEST_ASSERT_TRUE(s_aht->readMeasurementInt(&t, &h));
+  TEST_ASSERT_EQUAL_INT32(5000, t);                       // 50,00 °C
+  TEST_ASSERT_EQUAL_UINT16(500, h);                       // 50,0 %UR
+
+  ahtBruto(0xFFFFF, 0xFFFFF);
+  TEST_ASSERT_TRUE(s_aht->readMeasurementInt(&t, &h));
+  TEST_ASSERT_EQUAL_INT32(14999, t);                      // 150 °C - 1 LSB
+  TEST_ASSERT_EQUAL_UINT16(999, h);
+}
+
+void test_aht_varredura_completa(void) {
+  int32_t t;
+  uint16_t h;
+
+  // Umidade e temperatura nas mesmas 2^20 leituras (x e 2^20 - 1 - x)
+  for (uint32_t x = 0; x < 0x100000; x++) {
+    uint32_t y = 0xFFFFF - x;
+    ahtBruto(x, y);
+    TEST_ASSERT_TRUE(s_aht->readMeasurementInt(&t, &h));
+
+    // Folha de dados: RH = x / 2^20 * 100 %, T = y / 2^20 * 200 - 50 °C (truncados)
+    if (h != (uint16_t)((uint64_t)x * 1000 / 0x100000)) TEST_FAIL_MESSAGE("umidade fora da fórmula");
+    if (t != (int32_t)((uint64_t)y * 20000 / 0x100000) - 5000) TEST_FAIL_MESSAGE("temperatura fora da fórmula");
+  }
+}
+
+/**
+ * @brief Tempo médio por leitura [ns]
+ */
+template <typename F>
+static double mede(uint32_t n, F leitura) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++) leitura(i);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+void test_benchmark(void) {
+  const uint32_t n = 200000;
+  volatile uint32_t soma = 0;
+
+  double bmpFloat = mede(n, [&](uint32_t i) {
+    float t, p;
+    bmpBruto(519888 + (i & 0xFF), 415148 + (i & 0x3FF));
+    s_bmp->readAll(&t, &p);
+    soma += (uint32_t)p;
+  });
+  double bmpInt = mede(n, [&](uint32_t i) {
+    int32_t t;
+    uint32_t p;
+    bmpBruto(519888 + (i & 0xFF), 415148 + (i & 0x3FF));
+    s_bmp->readAllInt(&t, &p);
+    soma += p;
+  });
+  double ahtFloat = mede(n, [&](uint32_t i) {
+    sensors_event_t h, t;
+    ahtBruto(i & 0xFFFFF, ~i & 0xFFFFF);
+    s_aht->readMeasurement(&h, &t);
+    soma += (uint32_t)t.temperature;
+  });
+  double ahtInt = mede(n, [&](uint32_t i) {
+    int32_t t;
+    uint16_t h;
+    ahtBruto(i & 0xFFFFF, ~i & 0xFFFFF);
+    s_aht->readMeasurementInt(&t, &h);
+    soma += (uint32_t)t;
+  });
+
+  char msg[120];
+  snprintf(msg, sizeof(msg), "BMP280 readAll %.1f ns, readAllInt %.1f ns | AHT20 readMeasurement %.1f ns, Int %.1f ns",
+           bmpFloat, bmpInt, ahtFloat, ahtInt);
+  TEST_MESSAGE(msg);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_bmp_inicia);
+  RUN_TEST(test_bmp_vetor_da_folha_de_dados);
+  RUN_TEST(test_bmp_varredura_erro_menor_que_7pa);
+  RUN_TEST(test_aht_inicia);
+  RUN_TEST(test_aht_extremos);
+  RUN_TEST(test_aht_varredura_completa);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
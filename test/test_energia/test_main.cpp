@@ -0,0 +1,113 @@
+/**
+ * @file test_main.cpp
+ * @brief Modelo de consumo (Energia.cpp): corrente média e autonomia por tempo de ciclo
+ * @details Usa os parâmetros ENERGY_* e os tempos da espera do ACK do config.h
+ *          (ajuste as correntes com medições da placa) e imprime a tabela para
+ *          os ciclos aceitos por Validate_Cycle_Time(), com e sem ACK e com e
+ *          sem deep sleep:
+ *
+ *              pio test -e native -f test_energia -v
+ */
+
+#include <unity.h>
+#include "config.h"
+#include "../../src/Energia.cpp"
+
+static const uint8_t CICLOS[] = { 1, 5, 10, 15, 30, 60 };   // [min], Validate_Cycle_Time()
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fases_somam_o_ciclo(void) {
+  for (uint8_t k = 0; k < sizeof(CICLOS); k++) {
+    for (uint8_t caso = 0; caso < 4; caso++) {
+      bool ack = caso & 1, dorme = caso & 2;
+      uint32_t ciclo = CICLOS[k] * 60000UL;
+      Energia_Ciclo_Type c = energiaCiclo(ciclo, ack, dorme);
+      uint32_t total = c.ativoMs + c.txMs + c.sonoMs;
+      if (ack || (ciclo > CFM_TIMEOUT_VALUE)) TEST_ASSERT_EQUAL_UINT32(ciclo, total);
+      else TEST_ASSERT_GREATER_THAN(CFM_TIMEOUT_VALUE, total);     // o timeout do ACK estica o ciclo
+      TEST_ASSERT_EQUAL_UINT32(ENERGY_TX_TIME_MS, c.txMs);
+      if (!dorme) TEST_ASSERT_EQUAL_UINT32(0, c.sonoMs);
+    }
+  }
+}
+
+void test_ciclo_curto_nunca_dorme(void) {
+  // Ciclo menor que o tempo acordado + rádio: o próximo começa logo, só TX e acordado
+  uint32_t ciclo = (ENERGY_ACTIVE_TIME_MS + ENERGY_TX_TIME_MS) / 2;
+  Energia_Ciclo_Type c = energiaCiclo(ciclo, true, true);
+  TEST_ASSERT_EQUAL_UINT32(0, c.sonoMs);
+  TEST_ASSERT_EQUAL_UINT32(ENERGY_ACTIVE_TIME_MS + CFM_POLL_INTERVAL, c.ativoMs);
+
+  uint32_t i = energiaCorrenteMedia(c);
+  TEST_ASSERT_GREATER_OR_EQUAL(ENERGY_ACTIVE_CURRENT_UA, i);
+  TEST_ASSERT_LESS_OR_EQUAL(ENERGY_TX_CURRENT_UA, i);
+}
+
+void test_carga_por_ciclo(void) {
+  // 10 min com os valores padrão (45 / 120 / 0,25 mA; 1,5 s acordado, 2,5 s de rádio):
+  // ACK na consulta seguinte à RX2: (45 * 3,5 + 120 * 2,5 + 0,25 * 594) / 600
+  TEST_ASSERT_EQUAL_UINT32(1010, energiaCorrenteMedia(energiaCiclo(600000UL, true, true)));
+
+  // Sem ACK: 15 s consultando, sono até os 180 s e um boot, sono até o fim:
+  // (45 * 15,5 + 120 * 2,5 + 0,25 * 582) / 600
+  TEST_ASSERT_EQUAL_UINT32(1905, energiaCorrenteMedia(energiaCiclo(600000UL, false, true)));
+
+  // Sem deep sleep: (45 * 597,5 + 120 * 2,5) / 600
+  TEST_ASSERT_EQUAL_UINT32(45312, energiaCorrenteMedia(energiaCiclo(600000UL, true, false)));
+}
+
+void test_espera_do_ack_dorme(void) {
+  // O CFM_TIMEOUT_VALUE não é passado acordado: só a janela de consulta e o boot no fim
+  Energia_Ciclo_Type c = energiaCiclo(600000UL, false, true);
+  TEST_ASSERT_EQUAL_UINT32(CFM_POLL_WINDOW - ENERGY_TX_TIME_MS + 2 * ENERGY_ACTIVE_TIME_MS, c.ativoMs);
+  TEST_ASSERT_LESS_THAN(CFM_TIMEOUT_VALUE / 4, c.ativoMs);
+}
+
+void test_ciclo_longo_tende_ao_sono(void) {
+  uint32_t anterior = 0xFFFFFFFF;
+  for (uint8_t k = 0; k < sizeof(CICLOS); k++) {
+    uint32_t i = energiaCorrenteMedia(energiaCiclo(CICLOS[k] * 60000UL, true, true));
+    TEST_ASSERT_LESS_THAN(anterior, i);                   // ciclo maior, corrente menor
+    TEST_ASSERT_GREATER_THAN(ENERGY_SLEEP_CURRENT_UA, i);
+    anterior = i;
+  }
+
+  // Limite: só a corrente de sono
+  uint32_t dia = energiaCorrenteMedia(energiaCiclo(86400000UL, false, true));
+  TEST_ASSERT_INT_WITHIN(ENERGY_SLEEP_CURRENT_UA / 10 + 5, ENERGY_SLEEP_CURRENT_UA, dia);
+}
+
+void test_tabela(void) {
+  char linha[120];
+  snprintf(linha, sizeof(linha), "Bateria %u mAh; ativo %u uA x %u ms, TX %u uA x %u ms, sono %u uA",
+           (unsigned)ENERGY_BATTERY_MAH, (unsigned)ENERGY_ACTIVE_CURRENT_UA, (unsigned)ENERGY_ACTIVE_TIME_MS,
+           (unsigned)ENERGY_TX_CURRENT_UA, (unsigned)ENERGY_TX_TIME_MS, (unsigned)ENERGY_SLEEP_CURRENT_UA);
+  TEST_MESSAGE(linha);
+
+  for (uint8_t k = 0; k < sizeof(CICLOS); k++) {
+    uint32_t ciclo = CICLOS[k] * 60000UL;
+    uint32_t ack = energiaCorrenteMedia(energiaCiclo(ciclo, true, true));
+    uint32_t semAck = energiaCorrenteMedia(energiaCiclo(ciclo, false, true));
+    uint32_t acordado = energiaCorrenteMedia(energiaCiclo(ciclo, true, false));
+    if (ciclo > CFM_TIMEOUT_VALUE) TEST_ASSERT_LESS_THAN(semAck, ack);   // mais curto, o ciclo sem ACK estica
+    TEST_ASSERT_LESS_THAN(acordado, semAck);
+
+    snprintf(linha, sizeof(linha), "Ciclo %2u min: ACK %5lu uA (~%4lu dias) | sem ACK %5lu uA (~%4lu dias) | acordado %5lu uA",
+             (unsigned)CICLOS[k], (unsigned long)ack, (unsigned long)energiaAutonomiaDias(ack),
+             (unsigned long)semAck, (unsigned long)energiaAutonomiaDias(semAck), (unsigned long)acordado);
+    TEST_MESSAGE(linha);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fases_somam_o_ciclo);
+  RUN_TEST(test_ciclo_curto_nunca_dorme);
+  RUN_TEST(test_carga_por_ciclo);
+  RUN_TEST(test_espera_do_ack_dorme);
+  RUN_TEST(test_ciclo_longo_tende_ao_sono);
+  RUN_TEST(test_tabela);
+  return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * @file test_main.cpp
+ * @brief Gerenciador de falhas: causa do boot, recuperação e reinício por falhas seguidas
+ * @details O boot é simulado como no ESP32: a RAM (temporizadores) é zerada,
+ *          a memória RTC não inicializada (s_reg) fica, e a RTC comum
+ *          (s_seguidas) só fica na volta do deep sleep. A causa do reset vem
+ *          de fakeResetReason() e o esp_restart() só é contado.
+ */
+
+#include <unity.h>
+#include "LoggerHost.h"
+#include "esp_system.h"
+#include "config.h"
+#include "../../src/Temporizador.cpp"
+#include "../../src/Falhas.cpp"
+
+static uint32_t s_recuperacoes;
+
+static void onRecupera(void *arg) {
+  (void)arg;
+  s_recuperacoes++;
+}
+
+/**
+ * @brief Boot com a causa r (setup: iniFalhas e a recuperação do LoRa)
+ */
+static void boot(esp_reset_reason_t r) {
+  memset(s_tmr, 0, sizeof(s_tmr));                              // RAM
+  s_iniciada = false;
+  s_tmrReinicio = -1;
+  s_tmrRecupera = -1;
+  if (r != ESP_RST_DEEPSLEEP) s_seguidas = 0;                   // RTC_DATA_ATTR: só o deep sleep mantém
+
+  fakeResetReason() = r;
+  iniFalhas();
+  falhasRecuperacao(onRecupera);
+}
+
+/**
+ * @brief Passo do loop: avança o relógio e roda os temporizadores vencidos
+ */
+static void passo(uint32_t ms) {
+  delay(ms);
+  temporizadorProcessa();
+}
+
+void setUp(void) {
+  loggerNivel() = LOG_LEVEL_ERROR + 1;
+  memset(&s_reg, 0xA5, sizeof(s_reg));                          // RTC_NOINIT_ATTR: lixo no power-on
+  fakeMillis() = 0;
+  fakeRestarts() = 0;
+  s_recuperacoes = 0;
+  boot(ESP_RST_POWERON);
+}
+
+void tearDown(void) {}
+
+void test_power_on_zera_o_registro(void) {
+  TEST_ASSERT_EQUAL(REINICIO_ENERGIA, falhasCausaReinicio());
+  TEST_ASSERT_EQUAL_UINT16(0, falhasReinicios());
+  for (uint8_t f = 0; f < FALHA_QUANT; f++) TEST_ASSERT_EQUAL_UINT16(0, falhasTotal((t_eFalha)f));
+  TEST_ASSERT_EQUAL_UINT16(0, falhasTotal(FALHA_QUANT));        // fora do limite
+}
+
+void test_causa_do_boot(void) {
+  static const struct { esp_reset_reason_t r; t_eReinicio causa; } TABELA[] = {
+    { ESP_RST_EXT,      REINICIO_EXTERNO },
+    { ESP_RST_SW,       REINICIO_EXTERNO },                       // esp_restart não agendado
+    { ESP_RST_PANIC,    REINICIO_PANICO },
+    { ESP_RST_INT_WDT,  REINICIO_WATCHDOG },
+    { ESP_RST_TASK_WDT, REINICIO_WATCHDOG },
+    { ESP_RST_WDT,      REINICIO_WATCHDOG },
+    { ESP_RST_BROWNOUT, REINICIO_TENSAO },
+    { ESP_RST_UNKNOWN,  REINICIO_ENERGIA },
+    { ESP_RST_SDIO,     REINICIO_ENERGIA },
+  };
+
+  for (uint8_t k = 0; k < sizeof(TABELA) / sizeof(TABELA[0]); k++) {
+    boot(TABELA[k].r);
+    TEST_ASSERT_EQUAL(TABELA[k].causa, falhasCausaReinicio());
+    TEST_ASSERT_EQUAL_UINT16(k + 1, falhasReinicios());
+  }
+}
+
+void test_deep_sleep_nao_e_reinicio(void) {
+  boot(ESP_RST_PANIC);
+  falhaRegistra(FALHA_LORA_TX);
+  falhaRegistra(FALHA_LORA_TX);
+
+  boot(ESP_RST_DEEPSLEEP);
+  TEST_ASSERT_EQUAL(REINICIO_PANICO, falhasCausaReinicio());    // mantém a causa do último boot
+  TEST_ASSERT_EQUAL_UINT16(1, falhasReinicios());
+  TEST_ASSERT_EQUAL_UINT16(2, falhasTotal(FALHA_LORA_TX));
+
+  falhaRegistra(FALHA_LORA_TX);                                 // seguidas mantidas no sono: 3ª
+  passo(0);
+  TEST_ASSERT_EQUAL_UINT32(1, s_recuperacoes);
+}
+
+void test_registro_invalido_e_descartado(void) {
+  falhaRegistra(FALHA_ESTADO);
+  s_reg.magico = 0;                                             // memória corrompida
+  boot(ESP_RST_SW);
+  TEST_ASSERT_EQUAL(REINICIO_EXTERNO, falhasCausaReinicio());
+  TEST_ASSERT_EQUAL_UINT16(1, falhasReinicios());
+  TEST_ASSERT_EQUAL_UINT16(0, falhasTotal(FALHA_ESTADO));
+}
+
+void test_recuperacao_a_cada_fault_recover_after(void) {
+  for (uint8_t n = 1; n < MAX_SEQUENTIAL_ERRORS; n++) {
+    falhaRegistra(FALHA_LORA_CFM);
+    passo(1);
+    TEST_ASSERT_EQUAL_UINT32(n / FAULT_RECOVER_AFTER, s_recuperacoes);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, fakeRestarts());
+  TEST_ASSERT_EQUAL_UINT16(MAX_SEQUENTIAL_ERRORS - 1, falhasTotal(FALHA_LORA_CFM));
+}
+
+void test_sucesso_zera_as_seguidas(void) {
+  for (uint8_t k = 0; k < 4 * MAX_SEQUENTIAL_ERRORS; k++) {
+    for (uint8_t n = 0; n < FAULT_RECOVER_AFTER - 1; n++) falhaRegistra(FALHA_LORA_TX);
+    falhasLimpa();
+    passo(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, s_recuperacoes);
+  TEST_ASSERT_EQUAL_UINT32(0, fakeRestarts());
+  TEST_ASSERT_EQUAL_UINT16(4 * MAX_SEQUENTIAL_ERRORS * (FAULT_RECOVER_AFTER - 1), falhasTotal(FALHA_LORA_TX));
+}
+
+void test_reinicio_em_max_sequential_errors(void) {
+  for (uint8_t n = 0; n < MAX_SEQUENTIAL_ERRORS; n++) {
+    falhaRegistra((n & 1) ? FALHA_LORA_TX : FALHA_LORA_CFM);    // classes misturadas somam nas seguidas
+    passo(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, fakeRestarts());                  // agendado, não imediato
+  TEST_ASSERT_EQUAL_UINT32((MAX_SEQUENTIAL_ERRORS - 1) / FAULT_RECOVER_AFTER, s_recuperacoes);
+
+  falhaRegistra(FALHA_LORA_TX);                                 // não reagenda nem adia
+  passo(FAULT_RESTART_DELAY - 2);
+  TEST_ASSERT_EQUAL_UINT32(0, fakeRestarts());
+  passo(1);
+  TEST_ASSERT_EQUAL_UINT32(1, fakeRestarts());
+
+  boot(ESP_RST_SW);
+  TEST_ASSERT_EQUAL(REINICIO_FALHAS, falhasCausaReinicio());
+  TEST_ASSERT_EQUAL_UINT16(1, falhasReinicios());
+  TEST_ASSERT_EQUAL_UINT16(MAX_SEQUENTIAL_ERRORS / 2 + 1, falhasTotal(FALHA_LORA_TX));   // totais sobrevivem
+
+  falhaRegistra(FALHA_LORA_TX);                                 // seguidas recomeçam do zero
+  passo(FAULT_RESTART_DELAY);
+  TEST_ASSERT_EQUAL_UINT32(1, fakeRestarts());
+}
+
+void test_reinicio_pedido_mantem_a_primeira_causa(void) {
+  falhasReinicia(REINICIO_PEDIDO, 500);
+  falhasReinicia(REINICIO_FALHAS, 10);                          // já agendado: ignorado
+  passo(499);
+  TEST_ASSERT_EQUAL_UINT32(0, fakeRestarts());
+  passo(1);
+  TEST_ASSERT_EQUAL_UINT32(1, fakeRestarts());
+
+  boot(ESP_RST_SW);
+  TEST_ASSERT_EQUAL(REINICIO_PEDIDO, falhasCausaReinicio());
+
+  boot(ESP_RST_SW);                                             // esp_restart fora do agendamento
+  TEST_ASSERT_EQUAL(REINICIO_EXTERNO, falhasCausaReinicio());
+  TEST_ASSERT_EQUAL_UINT16(2, falhasReinicios());
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_power_on_zera_o_registro);
+  RUN_TEST(test_causa_do_boot);
+  RUN_TEST(test_deep_sleep_nao_e_reinicio);
+  RUN_TEST(test_registro_invalido_e_descartado);
+  RUN_TEST(test_recuperacao_a_cada_fault_recover_after);
+  RUN_TEST(test_sucesso_zera_as_seguidas);
+  RUN_TEST(test_reinicio_em_max_sequential_errors);
+  RUN_TEST(test_reinicio_pedido_mantem_a_primeira_causa);
+  return UNITY_END();
+}
@@ -0,0 +1,236 @@
+/**
+ * @file test_main.cpp
+ * @brief Frame v04 (keyframe/delta): ida e volta codificador/decodificador no host
+ * @details Monta os frames com montaPayloadDelta() sobre o histórico e os
+ *          decodifica com PayloadSchema::decodificaDelta(), como o servidor,
+ *          incluindo a regra de perda pelo FCnt e a idade máxima da fila.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Arduino.h"
+
+// Payload.cpp: dispensa os includes de hardware do Aplic.h (Sensores.h só declara os sensores)
+#define _APL_H
+#define global extern
+class Adafruit_AHTX0;
+class Adafruit_BMP280;
+#include "../../src/Historico.cpp"
+#include "../../src/Payload.cpp"
+
+using namespace PayloadSchema;
+
+static const uint32_t CICLO = 600;        // [s] entre amostras
+
+static uint32_t s_semente;
+static CPendio_Amostra_Type s_enviadas[64];   // amostras na ordem de historicoAdiciona()
+static uint32_t s_tempos[64];
+static uint8_t s_quantEnviadas;
+static bool s_varia;                      // proximaAmostra() muda os valores
+
+static uint32_t sorteia(void) {
+  s_semente = s_semente * 1664525UL + 1013904223UL;
+  return s_semente >> 8;
+}
+
+/**
+ * @brief Amostra com S, M e T presentes, variando pouco em relação à anterior
+ */
+static CPendio_Amostra_Type proximaAmostra(void) {
+  static CPendio_Amostra_Type a;
+  if (!a.spendio[0].valido) {
+    for (uint8_t i = 0; i < NUM_SPENDIO; i++) {
+      a.spendio[i].valido = true;
+      a.spendio[i].acx = 500 + i;
+      a.spendio[i].acy = 510;
+      a.spendio[i].acz = 700;
+      a.spendio[i].solo = 100000;
+    }
+    a.temp = 235;
+    a.umid = 60;
+    a.pressao = 93000;
+    a.pluv = 10;
+    a.bat = 3700;
+  }
+  if (!s_varia) return a;
+  for (uint8_t i = 0; i < NUM_SPENDIO; i++) {
+    a.spendio[i].acx = (uint16_t)(a.spendio[i].acx + (sorteia() % 7) - 3);
+    a.spendio[i].solo += sorteia() % 50;
+  }
+  a.temp = (int16_t)(a.temp + (int16_t)(sorteia() % 5) - 2);
+  a.pressao += (sorteia() % 41) - 20;
+  if (sorteia() % 4 == 0) a.pluv++;
+  return a;
+}
+
+static void comparaAmostra(const CPendio_Amostra_Type &esperada, const CPendio_Amostra_Type &lida) {
+  for (uint8_t i = 0; i < NUM_SPENDIO; i++) {
+    TEST_ASSERT_EQUAL(esperada.spendio[i].valido, lida.spendio[i].valido);
+    TEST_ASSERT_EQUAL_UINT16(esperada.spendio[i].acx, lida.spendio[i].acx);
+    TEST_ASSERT_EQUAL_UINT16(esperada.spendio[i].acy, lida.spendio[i].acy);
+    TEST_ASSERT_EQUAL_UINT16(esperada.spendio[i].acz, lida.spendio[i].acz);
+    TEST_ASSERT_EQUAL_UINT32(esperada.spendio[i].solo, lida.spendio[i].solo);
+  }
+  TEST_ASSERT_EQUAL_INT16(esperada.temp, lida.temp);
+  TEST_ASSERT_EQUAL_UINT8(esperada.umid, lida.umid);
+  TEST_ASSERT_EQUAL_UINT32(esperada.pressao, lida.pressao);
+  TEST_ASSERT_EQUAL_UINT16(esperada.pluv, lida.pluv);
+  TEST_ASSERT_EQUAL_UINT16(esperada.bat, lida.bat);
+}
+
+/**
+ * @brief Primeira amostra do frame é keyframe
+ */
+static bool comecaComKey(const uint8_t *frame) {
+  return getBits(frame, LOTE_BITS_VERSAO + LOTE_BITS_QUANT + LOTE_BITS_IDADE, DELTA_BITS_TIPO) != 0;
+}
+
+/**
+ * @brief Um ciclo do firmware: guarda a amostra e tenta montar o frame
+ * @return uint8_t Tamanho do frame (0 = amostra guardada)
+ */
+static uint8_t ciclo(uint32_t agora, uint16_t maxBytes, uint8_t *frame, uint8_t &n) {
+  s_enviadas[s_quantEnviadas] = proximaAmostra();
+  s_tempos[s_quantEnviadas] = agora;
+  historicoAdiciona(s_enviadas[s_quantEnviadas], agora);
+  s_quantEnviadas++;
+  return montaPayloadDelta(maxBytes, agora, frame, n);
+}
+
+void setUp(void) {
+  historicoDescarta(historicoQuant());
+  s_refValida = false;
+  s_framesDesdeKey = 0;
+  s_quantEnviadas = 0;
+  s_semente = 12345;
+  s_varia = true;
+}
+
+void tearDown(void) {}
+
+/**
+ * @brief Frames seguidos, sem perda: todas as amostras reconstruídas, na ordem
+ */
+static void idaEVolta(uint16_t maxBytes) {
+  EstadoDelta estado = EstadoDelta();
+  uint8_t frame[LORA_MAX_PAYLOAD];
+  CPendio_Amostra_Type a[LOTE_MAX];
+  uint16_t idade[LOTE_MAX];
+  bool ok[LOTE_MAX];
+  uint8_t proxima = 0, frames = 0, keys = 0;
+  uint32_t fcnt = 100;
+
+  for (uint32_t t = 0; s_quantEnviadas < 60; t += CICLO) {
+    uint8_t n;
+    uint8_t tam = ciclo(t, maxBytes, frame, n);
+    if (tam == 0) continue;
+
+    TEST_ASSERT_LESS_OR_EQUAL(maxBytes, tam);
+    if (comecaComKey(frame)) keys++;
+    TEST_ASSERT_EQUAL_UINT8(n, decodificaDelta(frame, tam, fcnt++, estado, a, idade, ok, LOTE_MAX));
+    for (uint8_t i = 0; i < n; i++, proxima++) {
+      TEST_ASSERT_TRUE(ok[i]);
+      TEST_ASSERT_EQUAL_UINT16(t - s_tempos[proxima], idade[i]);
+      comparaAmostra(s_enviadas[proxima], a[i]);
+    }
+    payloadDeltaAceito(n);
+    frames++;
+  }
+  TEST_ASSERT_EQUAL_UINT8(s_quantEnviadas - historicoQuant(), proxima);
+  TEST_ASSERT_GREATER_OR_EQUAL(frames / DELTA_KEYFRAME_INTERVAL, keys);   // keyframe forçado
+  TEST_ASSERT_LESS_THAN(frames, keys);                                    // mas não em todo frame
+}
+
+void test_ida_e_volta_dr0(void) {
+  idaEVolta(51);
+}
+
+void test_ida_e_volta_payload_maximo(void) {
+  idaEVolta(LORA_MAX_PAYLOAD);
+}
+
+void test_idade_maxima_envia_frame_incompleto(void) {
+  uint8_t frame[LORA_MAX_PAYLOAD];
+  uint8_t n;
+
+  TEST_ASSERT_EQUAL_UINT8(0, ciclo(0, LORA_MAX_PAYLOAD, frame, n));
+  TEST_ASSERT_EQUAL_UINT8(0, montaPayloadDelta(LORA_MAX_PAYLOAD, DELTA_MAX_AGE - 1, frame, n));
+  TEST_ASSERT_GREATER_THAN(0, montaPayloadDelta(LORA_MAX_PAYLOAD, DELTA_MAX_AGE, frame, n));
+  TEST_ASSERT_EQUAL_UINT8(1, n);
+}
+
+void test_fila_cheia_envia_frame(void) {
+  uint8_t frame[LORA_MAX_PAYLOAD];
+  uint8_t n = 0, tam = 0;
+
+  // Amostras iguais (deltas mínimos) em intervalo curto: só a fila cheia libera o frame
+  s_varia = false;
+  for (uint8_t i = 0; i < BATCH_MAX_SAMPLES && tam == 0; i++) tam = ciclo(i * 10, LORA_MAX_PAYLOAD, frame, n);
+  TEST_ASSERT_GREATER_THAN(0, tam);
+  TEST_ASSERT_EQUAL_UINT8(historicoCapacidade(), n);
+}
+
+/**
+ * @brief Regra de perda: FCnt com salto descarta os deltas até o próximo keyframe
+ */
+void test_perda_pelo_fcnt(void) {
+  EstadoDelta estado = EstadoDelta();
+  uint8_t frame[LORA_MAX_PAYLOAD];
+  CPendio_Amostra_Type a[LOTE_MAX];
+  uint16_t idade[LOTE_MAX];
+  bool ok[LOTE_MAX];
+  uint8_t n, tam;
+  uint32_t t = 0;
+
+  // Frame 1 (keyframe), recebido com FCnt 10
+  while ((tam = ciclo(t, 51, frame, n)) == 0) t += CICLO;
+  TEST_ASSERT_TRUE(comecaComKey(frame));
+  TEST_ASSERT_EQUAL_UINT8(n, decodificaDelta(frame, tam, 10, estado, a, idade, ok, LOTE_MAX));
+  payloadDeltaAceito(n);
+
+  // Frame 2 (delta) perdido no ar: FCnt 11 nunca chega
+  do { t += CICLO; } while ((tam = ciclo(t, 51, frame, n)) == 0);
+  TEST_ASSERT_FALSE(comecaComKey(frame));
+  payloadDeltaAceito(n);
+
+  // Frame 3 (delta) chega com FCnt 12: sem referência
+  do { t += CICLO; } while ((tam = ciclo(t, 51, frame, n)) == 0);
+  TEST_ASSERT_FALSE(comecaComKey(frame));
+  TEST_ASSERT_EQUAL_UINT8(n, decodificaDelta(frame, tam, 12, estado, a, idade, ok, LOTE_MAX));
+  for (uint8_t i = 0; i < n; i++) TEST_ASSERT_FALSE(ok[i]);
+  payloadDeltaAceito(n);
+
+  // Servidor pede keyframe (0x86): o próximo frame reconstrói de novo
+  payloadDeltaPerdido();
+  uint8_t primeira = s_quantEnviadas - historicoQuant();
+  do { t += CICLO; } while ((tam = ciclo(t, 51, frame, n)) == 0);
+  TEST_ASSERT_TRUE(comecaComKey(frame));
+  TEST_ASSERT_EQUAL_UINT8(n, decodificaDelta(frame, tam, 13, estado, a, idade, ok, LOTE_MAX));
+  for (uint8_t i = 0; i < n; i++) {
+    TEST_ASSERT_TRUE(ok[i]);
+    comparaAmostra(s_enviadas[primeira + i], a[i]);
+  }
+}
+
+void test_frame_invalido(void) {
+  EstadoDelta estado = EstadoDelta();
+  CPendio_Amostra_Type a[LOTE_MAX];
+  uint16_t idade[LOTE_MAX];
+  bool ok[LOTE_MAX];
+  uint8_t v02[] = { 0x02, 0x00, 0x00 };
+  uint8_t curto[] = { 0x04, 0x30 };        // três amostras anunciadas, nenhum dado
+
+  TEST_ASSERT_EQUAL_UINT8(0, decodificaDelta(v02, sizeof(v02), 1, estado, a, idade, ok, LOTE_MAX));
+  TEST_ASSERT_EQUAL_UINT8(0, decodificaDelta(curto, sizeof(curto), 2, estado, a, idade, ok, LOTE_MAX));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ida_e_volta_dr0);
+  RUN_TEST(test_ida_e_volta_payload_maximo);
+  RUN_TEST(test_idade_maxima_envia_frame_incompleto);
+  RUN_TEST(test_fila_cheia_envia_frame);
+  RUN_TEST(test_perda_pelo_fcnt);
+  RUN_TEST(test_frame_invalido);
+  return UNITY_END();
+}
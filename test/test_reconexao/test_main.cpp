@@ -0,0 +1,326 @@
+/**
+ * @file test_main.cpp
+ * @brief Recuo do JOIN: jitter semeado pelo DevEUI e um local de 100 dispositivos voltando de uma queda
+ * @details O local perde o gateway por QUEDA_MS. Cada dispositivo percebe a
+ *          queda no seu próximo uplink e segue o recuo de reconexaoFalhou(),
+ *          com o próprio registro (s_reg trocado a cada chamada). O JOIN
+ *          (SF12, um dos CANAIS sorteado) é aceito se o gateway voltou e
+ *          nenhum outro JOIN no mesmo canal se sobrepõe (ALOHA). Comparações
+ *          no mesmo local: a política anterior (um JOIN a cada
+ *          JOIN_TIMEOUT_VALUE, sem recuo) e o recuo sem jitter com a mesma
+ *          espera média (3/4 do teto). No segundo cenário a queda é de
+ *          energia: todos os dispositivos reiniciam juntos (BOOT_MS) com o
+ *          gateway ainda fora, e só o jitter os separa. Imprime o tempo no ar e a carga dos
+ *          JOINs com os parâmetros ENERGY_*:
+ *
+ *              pio test -e native -f test_reconexao -v
+ */
+
+#include <unity.h>
+#include <vector>
+#include "LoggerHost.h"
+#include "esp_system.h"
+#include "config.h"
+#include "../../src/Reconexao.cpp"
+
+static const uint16_t DISPOSITIVOS = 100;
+static const uint64_t QUEDA_MS = 6ULL * 3600000ULL;          // gateway fora do ar
+static const uint32_t CICLO_MS = 600000UL;                     // 10 min: a queda é percebida no próximo uplink
+static const uint32_t BOOT_MS = 2000;                          // queda de energia: todos percebem no boot
+static const uint64_t HORIZONTE_MS = QUEDA_MS + 24ULL * 3600000ULL;   // fim da simulação
+static const uint8_t CANAIS = 8;                               // AU915, sub-banda de 8 canais de 125 kHz
+static const uint8_t JOIN_REQUEST = 23;                        // [bytes] MHDR + JoinEUI + DevEUI + DevNonce + MIC
+
+/**
+ * @brief Tempo no ar em DR0 (SF12/125 kHz), mesma fórmula de LoRaHandler::getAirtime
+ * @param pl Payload PHY [bytes]
+ * @return uint32_t [ms]
+ */
+static uint32_t airtimeSF12(uint8_t pl) {
+  const int32_t sf = 12, de = 1;
+  const uint32_t tSimbolo = (1UL << sf) * 1000UL / 125;       // [us]
+  int32_t num = 8 * pl - 4 * sf + 28 + 16;
+  int32_t den = 4 * (sf - 2 * de);
+  uint32_t simbolos = 8 + (uint32_t)((num + den - 1) / den) * 5;
+  return (tSimbolo * 49 / 4 + simbolos * tSimbolo + 999) / 1000;
+}
+
+/**
+ * @brief Teto do recuo após n tentativas (Reconexao.h)
+ */
+static uint32_t tetoRecuo(uint16_t n) {
+  uint32_t teto = JOIN_BACKOFF_MIN;
+  for (uint16_t i = 1; (i < n) && (teto < JOIN_BACKOFF_MAX); i++) teto <<= 1;
+  return (teto > JOIN_BACKOFF_MAX) ? JOIN_BACKOFF_MAX : teto;
+}
+
+/**
+ * @brief DevEUI do dispositivo k (16 dígitos hexa, como o main.cpp lê do módulo)
+ */
+static void devEUI(uint16_t k, char *eui) {
+  char txt[17];
+  snprintf(txt, sizeof(txt), "0004A30B00F1%04X", (unsigned)k);
+  memcpy(eui, txt, 16);
+}
+
+enum t_ePolitica {
+  POLITICA_JITTER = 0,                                         // reconexaoFalhou(): entre a metade e o teto
+  POLITICA_SEM_JITTER,                                         // 3/4 do teto, a média do jitter, todos no mesmo passo
+  POLITICA_FIXA                                                // anterior: novo JOIN logo após o JOIN_TIMEOUT_VALUE
+};
+
+struct Dispositivo_Type {
+  Registro_Reconexao_Type reg;
+  uint64_t proximo;                                            // próximo JOIN [ms]
+  uint64_t inicio;                                             // JOIN no ar [ms]
+  uint8_t canal;
+  bool pendente;                                               // JOIN no ar, resultado ainda não decidido
+  bool conectado;
+};
+
+struct Join_Type {
+  uint64_t inicio;
+  uint8_t canal;
+  uint16_t disp;
+};
+
+struct Resultado_Type {
+  uint32_t joins;
+  uint32_t colisoes;                                           // JOINs perdidos com o gateway no ar
+  uint64_t airtimeMs;
+  uint64_t cargaUaMs;                                          // [uA.ms]
+  uint64_t ultimoMs;                                           // último dispositivo reconectado
+  uint32_t maiorEspera;
+  uint16_t semConexao;                                         // ainda fora no HORIZONTE_MS
+};
+
+static Dispositivo_Type s_disp[DISPOSITIVOS];
+static uint32_t s_semente;                                     // instantes da queda e canais (o recuo tem o seu)
+
+static uint32_t sorteioLocal(void) {
+  s_semente = s_semente * 1664525UL + 1013904223UL;
+  return s_semente >> 8;
+}
+
+/**
+ * @brief Registro do dispositivo k no módulo, chamada, registro de volta
+ */
+static uint32_t falhou(uint16_t k, t_ePolitica politica) {
+  s_reg = s_disp[k].reg;
+  uint32_t espera = reconexaoFalhou();
+  if (politica == POLITICA_SEM_JITTER) espera = tetoRecuo(s_reg.tentativas) / 4 * 3;
+  else if (politica == POLITICA_FIXA) espera = 0;
+  s_disp[k].reg = s_reg;
+  return espera;
+}
+
+static void conectou(uint16_t k) {
+  s_reg = s_disp[k].reg;
+  reconexaoOk();
+  s_disp[k].reg = s_reg;
+}
+
+/**
+ * @brief Simula o local do início da queda até todos reconectarem
+ * @param politica Espera depois de cada JOIN sem sucesso
+ * @param percebeMs Janela em que os dispositivos percebem a queda [ms]
+ */
+static Resultado_Type simula(t_ePolitica politica, uint32_t percebeMs) {
+  const uint32_t toa = airtimeSF12(JOIN_REQUEST);
+  Resultado_Type res;
+  memset(&res, 0, sizeof(res));
+  std::vector<Join_Type> noAr;
+
+  s_semente = 7;
+  fakeResetReason() = ESP_RST_POWERON;
+  for (uint16_t k = 0; k < DISPOSITIVOS; k++) {
+    char eui[16];
+    devEUI(k, eui);
+    memset(&s_reg, 0, sizeof(s_reg));
+    iniReconexao(eui, sizeof(eui));
+    memset(&s_disp[k], 0, sizeof(s_disp[k]));
+    s_disp[k].reg = s_reg;
+
+    uint64_t percebe = sorteioLocal() % percebeMs;             // uplink sem resposta (ou boot): link perdido
+    s_disp[k].proximo = percebe + falhou(k, politica);         // STATE_NOT_JOINED: recua antes do 1º JOIN
+  }
+
+  uint16_t conectados = 0;
+  while (conectados < DISPOSITIVOS) {
+    // Próximo evento: um JOIN sai, ou um JOIN no ar termina (o mais cedo)
+    int32_t sai = -1, termina = -1;
+    for (uint16_t k = 0; k < DISPOSITIVOS; k++) {
+      const Dispositivo_Type &d = s_disp[k];
+      if (d.conectado) continue;
+      if (d.pendente) {
+        if ((termina < 0) || (d.inicio < s_disp[termina].inicio)) termina = k;
+      } else if ((sai < 0) || (d.proximo < s_disp[sai].proximo)) {
+        sai = k;
+      }
+    }
+
+    if ((termina >= 0) && ((sai < 0) || (s_disp[termina].inicio + toa <= s_disp[sai].proximo))) {
+      // Fim do JOIN: todos os que se sobrepõem já saíram
+      Dispositivo_Type &d = s_disp[termina];
+      bool colidiu = false;
+      for (size_t j = 0; j < noAr.size(); j++) {
+        if ((noAr[j].disp == termina) || (noAr[j].canal != d.canal)) continue;
+        uint64_t a = noAr[j].inicio, b = d.inicio;
+        if (((a > b) ? a - b : b - a) < toa) colidiu = true;
+      }
+      d.pendente = false;
+      if ((d.inicio >= QUEDA_MS) && !colidiu) {
+        d.conectado = true;
+        conectados++;
+        conectou(termina);
+        if (d.inicio + toa > res.ultimoMs) res.ultimoMs = d.inicio + toa;
+      } else {
+        if (d.inicio >= QUEDA_MS) res.colisoes++;
+        uint32_t espera = falhou(termina, politica);
+        if (espera > res.maiorEspera) res.maiorEspera = espera;
+        d.proximo = d.inicio + JOIN_TIMEOUT_VALUE + espera;    // timeout do JOIN, depois o recuo
+      }
+      continue;
+    }
+
+    // JOIN no ar
+    Dispositivo_Type &d = s_disp[sai];
+    if (d.proximo > HORIZONTE_MS) break;
+    d.inicio = d.proximo;
+    d.canal = sorteioLocal() % CANAIS;
+    d.pendente = true;
+    Join_Type j = { d.inicio, d.canal, (uint16_t)sai };
+    noAr.push_back(j);
+    for (size_t i = 0; i < noAr.size();) {                     // só os que ainda podem se sobrepor
+      if (noAr[i].inicio + 2 * toa < d.inicio) noAr.erase(noAr.begin() + i);
+      else i++;
+    }
+
+    res.joins++;
+    res.airtimeMs += toa;
+    res.cargaUaMs += (uint64_t)ENERGY_TX_CURRENT_UA * toa
+                   + (uint64_t)ENERGY_ACTIVE_CURRENT_UA * (JOIN_TIMEOUT_VALUE - toa);   // acordado até o JoinAccept/timeout
+  }
+  res.semConexao = DISPOSITIVOS - conectados;
+  return res;
+}
+
+static void imprime(const char *nome, const Resultado_Type &r) {
+  char linha[192], fim[48];
+  if (r.semConexao) snprintf(fim, sizeof(fim), "%u sem conexão em 24 h", (unsigned)r.semConexao);
+  else snprintf(fim, sizeof(fim), "último %5.1f min após a volta", (r.ultimoMs - QUEDA_MS) / 60000.0);
+  snprintf(linha, sizeof(linha),
+           "%-10s JOINs %6lu (%4lu colisões) | no ar %8.1f s | carga %8.2f mAh (%7.3f mAh/disp.) | %s",
+           nome, (unsigned long)r.joins, (unsigned long)r.colisoes, r.airtimeMs / 1000.0,
+           r.cargaUaMs / 3.6e9, r.cargaUaMs / 3.6e9 / DISPOSITIVOS, fim);
+  TEST_MESSAGE(linha);
+}
+
+void setUp(void) {
+  loggerNivel() = LOG_LEVEL_ERROR + 1;
+}
+
+void tearDown(void) {}
+
+void test_airtime_do_join(void) {
+  TEST_ASSERT_EQUAL_UINT32(1483, airtimeSF12(JOIN_REQUEST));   // SF12/125 kHz, 23 bytes
+}
+
+void test_espera_entre_metade_e_teto(void) {
+  char eui[16];
+  devEUI(0, eui);
+  fakeResetReason() = ESP_RST_POWERON;
+  memset(&s_reg, 0, sizeof(s_reg));
+  iniReconexao(eui, sizeof(eui));
+
+  for (uint16_t n = 1; n <= 20; n++) {
+    uint32_t espera = reconexaoFalhou();
+    uint32_t teto = tetoRecuo(n);
+    TEST_ASSERT_GREATER_OR_EQUAL(teto / 2, espera);
+    TEST_ASSERT_LESS_OR_EQUAL(teto, espera);
+    TEST_ASSERT_EQUAL_UINT32(espera, reconexaoEspera());
+  }
+  TEST_ASSERT_EQUAL_UINT32(JOIN_BACKOFF_MAX, tetoRecuo(20));
+  reconexaoOk();
+  TEST_ASSERT_EQUAL_UINT32(0, reconexaoEspera());
+}
+
+void test_devEUI_semeia_sequencias_distintas(void) {
+  uint32_t primeira[DISPOSITIVOS];
+  uint16_t iguais = 0;
+  fakeResetReason() = ESP_RST_POWERON;
+
+  for (uint16_t k = 0; k < DISPOSITIVOS; k++) {
+    char eui[16];
+    devEUI(k, eui);
+    memset(&s_reg, 0, sizeof(s_reg));
+    iniReconexao(eui, sizeof(eui));
+    for (uint8_t n = 0; n < 8; n++) reconexaoFalhou();       // teto de 15 s * 2^7 = 32 min
+    primeira[k] = reconexaoEspera();
+    for (uint16_t j = 0; j < k; j++) if (primeira[j] == primeira[k]) iguais++;
+
+    // Mesmo DevEUI, mesma sequência
+    memset(&s_reg, 0, sizeof(s_reg));
+    iniReconexao(eui, sizeof(eui));
+    for (uint8_t n = 0; n < 8; n++) reconexaoFalhou();
+    TEST_ASSERT_EQUAL_UINT32(primeira[k], reconexaoEspera());
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(2, iguais);
+}
+
+void test_local_de_100_dispositivos(void) {
+  Resultado_Type comJitter = simula(POLITICA_JITTER, CICLO_MS);
+  Resultado_Type semJitter = simula(POLITICA_SEM_JITTER, CICLO_MS);
+  Resultado_Type fixa = simula(POLITICA_FIXA, CICLO_MS);
+
+  char linha[128];
+  snprintf(linha, sizeof(linha), "%u dispositivos, gateway fora do ar por %.1f h, JOIN SF12 %lu ms em %u canais",
+           (unsigned)DISPOSITIVOS, QUEDA_MS / 3600000.0, (unsigned long)airtimeSF12(JOIN_REQUEST), (unsigned)CANAIS);
+  TEST_MESSAGE(linha);
+  imprime("jitter", comJitter);
+  imprime("sem jitter", semJitter);
+  imprime("fixa 10 s", fixa);
+
+  const Resultado_Type *todos[] = { &comJitter, &semJitter, &fixa };
+  for (uint8_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_UINT16(0, todos[i]->semConexao);
+    TEST_ASSERT_GREATER_OR_EQUAL(DISPOSITIVOS, todos[i]->joins);
+    TEST_ASSERT_LESS_OR_EQUAL(JOIN_BACKOFF_MAX, todos[i]->maiorEspera);
+  }
+
+  // O recuo corta o tempo no ar e a carga dos JOINs da política anterior na mesma queda
+  TEST_ASSERT_TRUE_MESSAGE(comJitter.airtimeMs * 10 < fixa.airtimeMs, "tempo no ar não caiu 10x");
+  TEST_ASSERT_TRUE_MESSAGE(comJitter.cargaUaMs * 10 < fixa.cargaUaMs, "carga não caiu 10x");
+
+  TEST_ASSERT_TRUE_MESSAGE(semJitter.airtimeMs * 10 < fixa.airtimeMs, "tempo no ar sem jitter não caiu 10x");
+
+  // Todos voltam em até dois recuos máximos depois da volta do gateway
+  TEST_ASSERT_TRUE_MESSAGE(comJitter.ultimoMs - QUEDA_MS <= 2ULL * (JOIN_BACKOFF_MAX + JOIN_TIMEOUT_VALUE),
+                           "reconexão demorou mais que dois recuos máximos");
+}
+
+void test_local_sem_energia(void) {
+  // Todos percebem a queda no mesmo boot: sem jitter, recuam no mesmo passo e só o canal os separa
+  Resultado_Type comJitter = simula(POLITICA_JITTER, BOOT_MS);
+  Resultado_Type semJitter = simula(POLITICA_SEM_JITTER, BOOT_MS);
+  TEST_MESSAGE("Queda de energia do local (todos no mesmo boot):");
+  imprime("jitter", comJitter);
+  imprime("sem jitter", semJitter);
+
+  TEST_ASSERT_EQUAL_UINT16(0, comJitter.semConexao);
+  TEST_ASSERT_LESS_THAN(semJitter.colisoes, comJitter.colisoes);
+  TEST_ASSERT_TRUE(comJitter.airtimeMs < semJitter.airtimeMs);
+  TEST_ASSERT_TRUE(semJitter.semConexao || (comJitter.ultimoMs < semJitter.ultimoMs));
+  TEST_ASSERT_TRUE_MESSAGE(comJitter.ultimoMs - QUEDA_MS <= 2ULL * (JOIN_BACKOFF_MAX + JOIN_TIMEOUT_VALUE),
+                           "reconexão demorou mais que dois recuos máximos");
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_airtime_do_join);
+  RUN_TEST(test_espera_entre_metade_e_teto);
+  RUN_TEST(test_devEUI_semeia_sequencias_distintas);
+  RUN_TEST(test_local_de_100_dispositivos);
+  RUN_TEST(test_local_sem_energia);
+  return UNITY_END();
+}
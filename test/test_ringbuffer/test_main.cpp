@@ -0,0 +1,140 @@
+/**
+ * @file test_main.cpp
+ * @brief RingBuffer (lib RoboCore_SMW_SX1262M0): comportamento e microbenchmark
+ * @details O benchmark compara o anel com o algoritmo do Buffer até a v1.1
+ *          (read() e remove() deslocam o vetor inteiro), reproduzido em
+ *          BufferDeslocado. Os tempos são só informativos (não reprovam).
+ */
+
+#include <unity.h>
+#include <chrono>
+#include "Buffer.h"
+
+/**
+ * @brief Buffer v1.1: leitura pelo início com deslocamento do vetor
+ */
+template <uint8_t N>
+struct BufferDeslocado {
+  uint8_t v[N];
+  uint8_t n = 0;
+
+  void append(uint8_t b) { if (n < N) v[n++] = b; }
+  uint8_t read(void) {
+    if (n == 0) return 0;
+    uint8_t r = v[0];
+    for (uint8_t i = 0; i < n - 1; i++) v[i] = v[i + 1];
+    v[--n] = 0;
+    return r;
+  }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fifo_com_volta(void) {
+  RingBuffer<8> b;
+  uint8_t esperado = 0, escrito = 0;
+
+  for (int rodada = 0; rodada < 50; rodada++) {          // cabeça dá várias voltas
+    while (!b.isFull()) b.append(escrito++);
+    TEST_ASSERT_EQUAL_UINT8(8, b.available());
+    for (int i = 0; i < 5; i++) TEST_ASSERT_EQUAL_UINT8(esperado++, b.read());
+  }
+  TEST_ASSERT_EQUAL_UINT8(esperado, b.peek());
+}
+
+void test_remove_dos_dois_lados(void) {
+  RingBuffer<10> b;
+  for (uint8_t i = 0; i < 6; i++) b.append(0xAA);
+  for (uint8_t i = 0; i < 6; i++) b.read();               // cabeça no meio do vetor
+  for (uint8_t i = 0; i < 8; i++) b.append(i);            // 0..7, com volta
+
+  b.remove(1);                                            // lado da cabeça
+  b.remove(5);                                            // lado da cauda (era o 6)
+  uint8_t esperado[] = { 0, 2, 3, 4, 5, 7 };
+  TEST_ASSERT_EQUAL_UINT8(sizeof(esperado), b.available());
+  for (uint8_t i = 0; i < sizeof(esperado); i++) TEST_ASSERT_EQUAL_UINT8(esperado[i], b[i]);
+
+  b.remove(b.available());                                // fora do limite: nada muda
+  TEST_ASSERT_EQUAL_UINT8(sizeof(esperado), b.available());
+}
+
+void test_resize_limita_e_mantem_os_antigos(void) {
+  RingBuffer<16> b(4);
+  TEST_ASSERT_EQUAL_UINT8(4, b.size());
+  for (uint8_t i = 0; i < 10; i++) b.append(i);
+  TEST_ASSERT_EQUAL_UINT8(4, b.available());              // cheio no tamanho, não na capacidade
+
+  b.resize(2);
+  TEST_ASSERT_EQUAL_UINT8(2, b.available());
+  TEST_ASSERT_EQUAL_UINT8(0, b[0]);
+  TEST_ASSERT_EQUAL_UINT8(1, b[1]);
+
+  b.resize(200);
+  TEST_ASSERT_EQUAL_UINT8(16, b.size());                  // limitado à capacidade
+  TEST_ASSERT_EQUAL_UINT8(1, RingBuffer<16>(0).size());   // mínimo 1
+}
+
+void test_view_sub_find(void) {
+  RingBuffer<12> b;
+  const char *msg = "12:CAFE";
+  for (uint8_t i = 0; i < 9; i++) { b.append('x'); b.read(); }   // força a volta
+  for (const char *p = msg; *p; p++) b.append(*p);
+
+  BufferView v = b.view();
+  uint8_t dp = v.find(':');
+  TEST_ASSERT_EQUAL_UINT8(2, dp);
+  BufferView payload = v.sub(dp + 1);
+  TEST_ASSERT_EQUAL_UINT8(4, payload.length());
+
+  uint8_t out[8] = {};
+  TEST_ASSERT_EQUAL_UINT8(4, payload.copy(out, sizeof(out)));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY("CAFE", out, 4);
+  TEST_ASSERT_EQUAL_UINT8(0, payload[4]);                 // fora do limite
+  TEST_ASSERT_EQUAL_UINT8(v.length(), v.find('#'));       // não encontrado
+}
+
+void test_buffer_ocupa_a_capacidade(void) {
+  // Custo em RAM documentado em Buffer.h: BUFFER_MAX_SIZE + 3 bytes por instância
+  TEST_ASSERT_EQUAL(BUFFER_MAX_SIZE + 3, sizeof(Buffer));
+}
+
+/**
+ * @brief Enche e esvazia pelo início (padrão do _read_response / readX)
+ * @return double [ns] por byte
+ */
+template <typename B>
+static double enche_esvazia(uint32_t rodadas, uint32_t &soma) {
+  B b;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < rodadas; r++) {
+    for (uint8_t i = 0; i < BUFFER_MAX_SIZE; i++) b.append((uint8_t)(r + i));
+    for (uint8_t i = 0; i < BUFFER_MAX_SIZE; i++) soma += b.read();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (rodadas * (double)BUFFER_MAX_SIZE);
+}
+
+void test_benchmark_leitura(void) {
+  const uint32_t rodadas = 20000;
+  uint32_t soma1 = 0, soma2 = 0;
+  double deslocado = enche_esvazia<BufferDeslocado<BUFFER_MAX_SIZE> >(rodadas, soma1);
+  double anel = enche_esvazia<RingBuffer<BUFFER_MAX_SIZE> >(rodadas, soma2);
+  TEST_ASSERT_EQUAL_UINT32(soma1, soma2);                 // mesmos bytes, mesma ordem
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "append+read de %u bytes: v1.1 %.2f ns/byte, anel %.2f ns/byte (%.1fx)",
+           (unsigned)BUFFER_MAX_SIZE, deslocado, anel, deslocado / anel);
+  TEST_MESSAGE(msg);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fifo_com_volta);
+  RUN_TEST(test_remove_dos_dois_lados);
+  RUN_TEST(test_resize_limita_e_mantem_os_antigos);
+  RUN_TEST(test_view_sub_find);
+  RUN_TEST(test_buffer_ocupa_a_capacidade);
+  RUN_TEST(test_benchmark_leitura);
+  return UNITY_END();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file test_main.cpp
+ * @brief Emulador do barramento SPendio: descoberta e negociação binário/ASCII
+ * @details rs485Pede()/rs485Resultado() são substituídos por um barramento
+ *          emulado, com nós só ASCII, nós binários, nós ausentes e nós que
+ *          perdem alguns pedidos. O tempo avança o prazo de cada pedido sem
+ *          resposta e a duração da resposta nos demais.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include "LoggerHost.h"
+
+// SPendio.cpp: dispensa os includes de hardware do Aplic.h (Sensores.h só declara os sensores)
+#define _APL_H
+#define global extern
+#define SPENDIO_TIMEOUT 200               // Aplic.h
+class Adafruit_AHTX0;
+class Adafruit_BMP280;
+#include "Sensores.h"
+#include "../../src/SPendio.cpp"
+
+enum Firmware { AUSENTE = 0, SO_ASCII, BINARIO };
+
+struct No_Emulado {
+  Firmware firmware;
+  uint8_t perde;                          // próximos pedidos sem resposta
+  uint16_t acx, acy, acz;
+  uint32_t solo;
+  uint16_t pedidosBin, pedidosAscii;
+};
+
+struct Pedido_Emulado {
+  char endereco;
+  uint16_t prazo;
+  bool binario;
+};
+
+static No_Emulado s_nos[SPENDIO_MAX];
+static Pedido_Emulado s_fila[RS485_MAX_PEDIDOS];
+static uint8_t s_naFila;
+
+//------------------------------------------------------------------------------
+//  Barramento emulado (RS485.h)
+//
+bool rs485Pede(char endereco, uint16_t prazo, bool binario) {
+  if (s_naFila == RS485_MAX_PEDIDOS) return false;
+  s_fila[s_naFila].endereco = endereco;
+  s_fila[s_naFila].prazo = prazo;
+  s_fila[s_naFila].binario = binario;
+  s_naFila++;
+  return true;
+}
+
+bool rs485Resultado(RS485_Transacao_Type &t, uint32_t espera) {
+  (void)espera;
+  if (s_naFila == 0) return false;
+
+  Pedido_Emulado p = s_fila[0];
+  memmove(s_fila, s_fila + 1, --s_naFila * sizeof(s_fila[0]));
+
+  memset(&t, 0, sizeof(t));
+  t.endereco = p.endereco;
+  t.binario = p.binario;
+
+  No_Emulado &no = s_nos[strchr(SPENDIO_ENDERECOS, p.endereco) - SPENDIO_ENDERECOS];
+  if (p.binario) no.pedidosBin++;
+  else no.pedidosAscii++;
+
+  bool responde = (no.firmware != AUSENTE) && !(p.binario && no.firmware == SO_ASCII);
+  if (responde && no.perde) {
+    no.perde--;
+    responde = false;
+  }
+  if (!responde) {
+    t.status = RS485_TIMEOUT;
+    t.duracao = p.prazo;
+  }
+  else if (p.binario) {
+    uint8_t *f = (uint8_t *)t.resposta;
+    f[0] = SPENDIO_BIN_LEN;
+    f[1] = (uint8_t)p.endereco;
+    f[2] = (uint8_t)(no.acx >> 4);
+    f[3] = (uint8_t)((no.acx << 4) | (no.acy >> 8));
+    f[4] = (uint8_t)no.acy;
+    f[5] = (uint8_t)(no.acz >> 4);
+    f[6] = (uint8_t)((no.acz << 4) | (no.solo >> 16));
+    f[7] = (uint8_t)(no.solo >> 8);
+    f[8] = (uint8_t)no.solo;
+    t.tam = SPENDIO_BIN_LEN + 3;          // CRC conferido pelo RS485.cpp
+    t.status = RS485_OK;
+    t.duracao = 23;
+  }
+  else {
+    snprintf(t.resposta, sizeof(t.resposta), "%03X,%03X,%03X,%05lX", no.acx, no.acy, no.acz, (unsigned long)no.solo);
+    t.tam = (uint8_t)strlen(t.resposta);
+    t.status = RS485_OK;
+    t.duracao = 38;
+  }
+  fakeMillis() += t.duracao;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//  Cenário
+//
+static No_Emulado &no(char endereco) {
+  return s_nos[strchr(SPENDIO_ENDERECOS, endereco) - SPENDIO_ENDERECOS];
+}
+
+static void instala(char endereco, Firmware firmware) {
+  No_Emulado &n = no(endereco);
+  n.firmware = firmware;
+  n.acx = 0x200 + endereco;
+  n.acy = 0x1F0;
+  n.acz = 0x3A5;
+  n.solo = 0x12345 + endereco;
+}
+
+static uint8_t modo(char endereco) {
+  return s_modoSPendio[strchr(SPENDIO_ENDERECOS, endereco) - SPENDIO_ENDERECOS];
+}
+
+static void zeraContagem(void) {
+  for (uint8_t i = 0; i < SPENDIO_MAX; i++) s_nos[i].pedidosBin = s_nos[i].pedidosAscii = 0;
+}
+
+static void confereLeitura(const CPendio_Amostra_Type &a, char endereco) {
+  const SPendio_Amostra_Type &sp = a.spendio[strchr(SPENDIO_ENDERECOS, endereco) - SPENDIO_ENDERECOS];
+  TEST_ASSERT_TRUE(sp.valido);
+  TEST_ASSERT_EQUAL_UINT16(no(endereco).acx, sp.acx);
+  TEST_ASSERT_EQUAL_UINT16(no(endereco).acy, sp.acy);
+  TEST_ASSERT_EQUAL_UINT16(no(endereco).acz, sp.acz);
+  TEST_ASSERT_EQUAL_UINT32(no(endereco).solo, sp.solo);
+}
+
+void setUp(void) {
+  memset(s_nos, 0, sizeof(s_nos));
+  memset(s_modoSPendio, 0, sizeof(s_modoSPendio));
+  s_naFila = 0;
+  s_registro = 0;
+  s_registroFeito = false;
+  s_varreduras = 0;
+  loggerNivel() = LOG_LEVEL_ERROR + 1;
+}
+
+void tearDown(void) {}
+
+void test_descoberta_registra_quem_responde(void) {
+  instala('S', SO_ASCII);
+  instala('M', BINARIO);
+  instala('A', BINARIO);                  // T ausente
+  descobreSPendio();
+  TEST_ASSERT_EQUAL_HEX16((1U << 0) | (1U << 1) | (1U << 3), registroSPendio());
+
+  // Só no power-on: a segunda chamada não varre o barramento
+  zeraContagem();
+  descobreSPendio();
+  TEST_ASSERT_EQUAL_UINT16(0, no('S').pedidosAscii);
+}
+
+void test_negociacao_na_primeira_varredura(void) {
+  CPendio_Amostra_Type a;
+  instala('S', SO_ASCII);
+  instala('M', BINARIO);
+  instala('T', BINARIO);
+  descobreSPendio();
+
+  varrSensoresSPendio(a);
+  confereLeitura(a, 'S');                 // ASCII refeito na mesma varredura
+  confereLeitura(a, 'M');
+  confereLeitura(a, 'T');
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_ASCII, modo('S'));
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_BINARIO, modo('M'));
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_BINARIO, modo('T'));
+
+  // Depois: um pedido por nó, no modo negociado
+  zeraContagem();
+  varrSensoresSPendio(a);
+  TEST_ASSERT_EQUAL_UINT16(0, no('S').pedidosBin);
+  TEST_ASSERT_EQUAL_UINT16(1, no('S').pedidosAscii);
+  TEST_ASSERT_EQUAL_UINT16(1, no('M').pedidosBin);
+  TEST_ASSERT_EQUAL_UINT16(0, no('M').pedidosAscii);
+}
+
+void test_timeout_nao_fixa_ascii(void) {
+  CPendio_Amostra_Type a;
+  instala('S', BINARIO);
+  descobreSPendio();
+
+  // Nó binário ocupado: não responde a nenhum pedido da primeira varredura
+  no('S').perde = 2;
+  varrSensoresSPendio(a);
+  TEST_ASSERT_FALSE(a.spendio[0].valido);
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_DESCONHECIDO, modo('S'));
+
+  // Na seguinte negocia o binário
+  varrSensoresSPendio(a);
+  confereLeitura(a, 'S');
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_BINARIO, modo('S'));
+}
+
+void test_nova_tentativa_binaria(void) {
+  CPendio_Amostra_Type a;
+  instala('S', BINARIO);
+  descobreSPendio();
+
+  // Perde só o pedido binário: responde ao ASCII e fica em ASCII
+  no('S').perde = 1;
+  varrSensoresSPendio(a);
+  confereLeitura(a, 'S');
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_ASCII, modo('S'));
+
+  // Até SPENDIO_BINARY_RETRY varreduras depois da primeira, só ASCII
+  zeraContagem();
+  for (uint16_t k = 1; k < SPENDIO_BINARY_RETRY - 1; k++) varrSensoresSPendio(a);
+  TEST_ASSERT_EQUAL_UINT16(0, no('S').pedidosBin);
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_ASCII, modo('S'));
+
+  varrSensoresSPendio(a);
+  confereLeitura(a, 'S');
+  TEST_ASSERT_EQUAL_UINT16(1, no('S').pedidosBin);
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_BINARIO, modo('S'));
+}
+
+void test_so_ascii_continua_lido_na_nova_tentativa(void) {
+  CPendio_Amostra_Type a;
+  instala('S', SO_ASCII);
+  descobreSPendio();
+
+  for (uint16_t k = 0; k < 3 * SPENDIO_BINARY_RETRY; k++) {
+    varrSensoresSPendio(a);
+    confereLeitura(a, 'S');                // nenhuma varredura sem leitura
+    TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_ASCII, modo('S'));
+  }
+  TEST_ASSERT_EQUAL_UINT16(3 + 1, no('S').pedidosBin);   // primeira + uma por SPENDIO_BINARY_RETRY
+}
+
+void test_no_binario_ausente_nao_vira_ascii(void) {
+  CPendio_Amostra_Type a;
+  instala('S', BINARIO);
+  descobreSPendio();
+  varrSensoresSPendio(a);
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_BINARIO, modo('S'));
+
+  // Nó desligado: falha o ciclo, sem pedido ASCII nem troca de modo
+  no('S').firmware = AUSENTE;
+  zeraContagem();
+  varrSensoresSPendio(a);
+  TEST_ASSERT_FALSE(a.spendio[0].valido);
+  TEST_ASSERT_EQUAL_UINT16(0, no('S').pedidosAscii);
+  TEST_ASSERT_EQUAL_UINT8(SPENDIO_MODO_BINARIO, modo('S'));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_descoberta_registra_quem_responde);
+  RUN_TEST(test_negociacao_na_primeira_varredura);
+  RUN_TEST(test_timeout_nao_fixa_ascii);
+  RUN_TEST(test_nova_tentativa_binaria);
+  RUN_TEST(test_so_ascii_continua_lido_na_nova_tentativa);
+  RUN_TEST(test_no_binario_ausente_nao_vira_ascii);
+  return UNITY_END();
+}
@@ -0,0 +1,210 @@
+/**
+ * @file test_main.cpp
+ * @brief Temporizador (roda hierárquica): vencimentos na passagem do millis() por zero
+ * @details O teste aleatório arma, desarma e avança o relógio falso a partir
+ *          de pouco antes de 0xFFFFFFFF, atravessando várias voltas de
+ *          ~49,7 dias. Um modelo guarda o prazo de cada temporizador e confere,
+ *          a cada temporizadorProcessa(), que nenhum vence antes do prazo e que
+ *          nenhum vencido fica para trás.
+ */
+
+#include <unity.h>
+#include "Arduino.h"
+#include "../../src/Temporizador.cpp"
+
+static const uint32_t PERTO_DO_ZERO = 0xFFFFFFFFUL - 3600000UL;   // 1 h antes da volta
+
+// Modelo: o que cada temporizador deveria estar fazendo
+struct Modelo_Type {
+  bool armado;
+  uint32_t prazo;
+  uint32_t periodo;
+};
+
+static Modelo_Type s_modelo[TEMPORIZADOR_MAX];
+static uint32_t s_disparos[TEMPORIZADOR_MAX];
+static uint32_t s_ultimoDisparo[TEMPORIZADOR_MAX];
+static uint32_t s_total;
+static uint32_t s_semente;
+
+static uint32_t sorteia(void) {
+  s_semente = s_semente * 1664525UL + 1013904223UL;
+  return s_semente >> 8;
+}
+
+/**
+ * @brief Callback: confere o disparo contra o modelo e o atualiza como a roda
+ */
+static void onVence(void *arg) {
+  uint8_t i = (uint8_t)(uintptr_t)arg;
+  uint32_t agora = millis();
+  Modelo_Type &m = s_modelo[i];
+
+  TEST_ASSERT_TRUE_MESSAGE(m.armado, "disparo de temporizador desarmado");
+  TEST_ASSERT_TRUE_MESSAGE((int32_t)(agora - m.prazo) >= 0, "disparo antes do prazo");
+
+  if (m.periodo) {                                              // mesma regra do rearme periódico
+    m.prazo += m.periodo;
+    if ((int32_t)(m.prazo - agora) <= 0) m.prazo = agora + m.periodo;
+  } else {
+    m.armado = false;
+  }
+  s_disparos[i]++;
+  s_ultimoDisparo[i] = agora;
+  s_total++;
+}
+
+/**
+ * @brief Processa e confere que nenhum prazo vencido ficou para trás
+ */
+static void processa(void) {
+  temporizadorProcessa();
+  uint32_t agora = millis();
+  for (uint8_t i = 0; i < TEMPORIZADOR_MAX; i++) {
+    if (!s_modelo[i].armado) continue;
+    if ((int32_t)(s_modelo[i].prazo - agora) <= 0) {
+      char msg[96];
+      snprintf(msg, sizeof(msg), "temporizador %u perdido: prazo 0x%08lX, agora 0x%08lX",
+               (unsigned)i, (unsigned long)s_modelo[i].prazo, (unsigned long)agora);
+      TEST_FAIL_MESSAGE(msg);
+    }
+    TEST_ASSERT_EQUAL_UINT32(s_modelo[i].prazo - agora, temporizadorRestante(i));
+  }
+}
+
+static void arma(uint8_t i, uint32_t prazo, uint32_t periodo) {
+  temporizadorArma(i, prazo, periodo);
+  s_modelo[i].armado = true;
+  s_modelo[i].prazo = prazo;
+  s_modelo[i].periodo = periodo;
+}
+
+static void desarma(uint8_t i) {
+  temporizadorDesarma(i);
+  s_modelo[i].armado = false;
+}
+
+/**
+ * @brief Cria todos os temporizadores (metade limita o deep sleep)
+ */
+static void criaTodos(void) {
+  for (uint8_t i = 0; i < TEMPORIZADOR_MAX; i++) {
+    TEST_ASSERT_EQUAL_INT8(i, temporizadorCria(onVence, (i & 1) == 0, (void *)(uintptr_t)i));
+  }
+  TEST_ASSERT_EQUAL_INT8(-1, temporizadorCria(onVence));                    // sem temporizador livre
+}
+
+void setUp(void) {
+  memset(s_tmr, 0, sizeof(s_tmr));
+  s_iniciada = false;
+  memset(s_modelo, 0, sizeof(s_modelo));
+  memset(s_disparos, 0, sizeof(s_disparos));
+  memset(s_ultimoDisparo, 0, sizeof(s_ultimoDisparo));
+  s_total = 0;
+}
+
+void tearDown(void) {}
+
+void test_prazo_depois_do_zero(void) {
+  fakeMillis() = 0xFFFFFF00UL;
+  criaTodos();
+  arma(0, 0x00000100UL, 0);                                     // 512 ms à frente, do outro lado do zero
+
+  while (s_disparos[0] == 0) {
+    delay(1);
+    processa();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0x00000100UL, s_ultimoDisparo[0]);   // no ms exato
+}
+
+void test_periodico_atravessa_o_zero(void) {
+  fakeMillis() = 0xFFFFF000UL;
+  criaTodos();
+  arma(1, millis() + 1000, 1000);
+
+  for (uint32_t k = 0; k < 10000; k++) {
+    delay(1);
+    processa();
+  }
+  TEST_ASSERT_EQUAL_UINT32(10, s_disparos[1]);
+  TEST_ASSERT_EQUAL_UINT32(0xFFFFF000UL + 10000, s_ultimoDisparo[1]);
+}
+
+void test_prazo_longo_nivel_de_cima(void) {
+  // Prazo no último nível da roda: desce em cascata até o nível 0 através da volta
+  fakeMillis() = PERTO_DO_ZERO;
+  criaTodos();
+  uint32_t prazo = millis() + 0x40000000UL;                     // ~12 dias
+  arma(2, prazo, 0);
+
+  delay(0x40000000UL - 1);
+  processa();
+  TEST_ASSERT_EQUAL_UINT32(0, s_disparos[2]);
+  delay(1);
+  processa();
+  TEST_ASSERT_EQUAL_UINT32(1, s_disparos[2]);
+  TEST_ASSERT_EQUAL_UINT32(prazo, s_ultimoDisparo[2]);
+}
+
+void test_proximo_atravessa_o_zero(void) {
+  fakeMillis() = 0xFFFFFFF0UL;
+  criaTodos();
+  arma(3, 0x00000010UL, 0);                                     // acorda = false: não conta
+  arma(4, 0x00000020UL, 0);
+
+  uint32_t espera;
+  TEST_ASSERT_TRUE(temporizadorProximo(espera));
+  TEST_ASSERT_EQUAL_UINT32(0x30, espera);
+  desarma(4);
+  TEST_ASSERT_FALSE(temporizadorProximo(espera));
+}
+
+void test_aleatorio_passagem_por_zero(void) {
+  s_semente = 2025;
+  fakeMillis() = PERTO_DO_ZERO;
+  criaTodos();
+
+  uint32_t voltas = 0, inicio = millis(), anterior = millis();
+  for (uint32_t k = 0; k < 200000; k++) {
+    uint8_t i = sorteia() % TEMPORIZADOR_MAX;
+    uint32_t sorteio = sorteia() % 100;
+
+    // Ação: arma (prazo futuro, já vencido ou periódico) ou desarma
+    if (sorteio < 40) {
+      uint32_t escala = (sorteia() % 4 == 0) ? (1UL << 28) : (sorteia() % 2 ? 65536UL : 300UL);
+      arma(i, millis() + 1 + sorteia() % escala, 0);
+    } else if (sorteio < 45) {
+      arma(i, millis() - sorteia() % 1000, 0);                  // já vencido: roda no próximo processamento
+    } else if (sorteio < 55) {
+      arma(i, millis() + sorteia() % 5000, 1 + sorteia() % 100000);
+    } else if (sorteio < 65) {
+      desarma(i);
+    }
+
+    // Avanço: ms a ms, passos médios ou saltos longos (sempre < 2^30)
+    uint32_t tipo = sorteia() % 10;
+    uint32_t passo = (tipo < 5) ? sorteia() % 4 : (tipo < 9) ? sorteia() % 70000 : sorteia() % (1UL << 27);
+    delay(passo);
+    processa();
+
+    if (millis() < anterior) voltas++;
+    anterior = millis();
+  }
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%lu disparos, %lu voltas do millis() a partir de 0x%08lX",
+           (unsigned long)s_total, (unsigned long)voltas, (unsigned long)inicio);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_GREATER_OR_EQUAL(2, voltas);
+  TEST_ASSERT_GREATER_THAN(10000, s_total);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_prazo_depois_do_zero);
+  RUN_TEST(test_periodico_atravessa_o_zero);
+  RUN_TEST(test_prazo_longo_nivel_de_cima);
+  RUN_TEST(test_proximo_atravessa_o_zero);
+  RUN_TEST(test_aleatorio_passagem_por_zero);
+  return UNITY_END();
+}